@@ -1,5 +1,7 @@
 import json
+import re
 import subprocess
+import socket
 import os
 from flask import Flask, request, jsonify, send_from_directory
 from flask_cors import CORS
@@ -9,11 +11,51 @@ app = Flask(__name__, static_folder='../frontend', static_url_path='/')
 CORS(app)
 
 # --- Configuration for C++ Executable ---
-# Compile C++: g++ ../core_logic/attendance_system.cpp -o ../core_logic/attendance_app
+# Compile C++: g++ -std=c++17 -O2 -pthread ../core_logic/attendance_system.cpp -o ../core_logic/attendance_app
+# (-pthread: the streaks report analyses the roster on several threads)
 CPP_EXECUTABLE_PATH = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', 'core_logic', 'attendance_app'))
 
+# Socket of a running "attendance_app serve" (start it from this directory:
+#   ../core_logic/attendance_app serve
+# ). When it is not running, each request falls back to spawning the executable.
+CPP_SOCKET_PATH = os.environ.get('ATTENDANCE_SOCKET', os.path.join(os.path.dirname(os.path.abspath(__file__)), 'attendance_app.sock'))
+
+# --- Helper function to talk to the persistent C++ server ---
+def call_cpp_server(command, *args):
+    """Sends one command line to the server and returns the parsed JSON reply, or None if the server is unavailable.
+
+    Only a failed connect returns None (so the caller falls back to the executable): once the
+    line is sent the server may already have applied it, and running it again could mark twice.
+    """
+    if not hasattr(socket, 'AF_UNIX') or not os.path.exists(CPP_SOCKET_PATH):
+        return None
+    # The protocol is one whitespace-separated line per request
+    if any(not arg or any(ch.isspace() for ch in arg) for arg in args):
+        return {"status": "error", "message": "Arguments must not be empty or contain whitespace"}
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        sock.connect(CPP_SOCKET_PATH)
+    except OSError:
+        sock.close()
+        return None
+    with sock:
+        try:
+            sock.sendall((' '.join([command] + list(args)) + '\n').encode())
+            reply = b''
+            while not reply.endswith(b'\n'):
+                chunk = sock.recv(65536)
+                if not chunk:
+                    raise ConnectionError("closed before replying")
+                reply += chunk
+            return json.loads(reply)
+        except (OSError, json.JSONDecodeError) as e:
+            return {"status": "error", "message": f"Lost connection to the attendance server: {e}"}
+
 # --- Helper function to call the C++ executable ---
 def call_cpp_logic(command, *args):
+    result = call_cpp_server(command, *args)
+    if result is not None:
+        return result
     try:
         cmd_list = [CPP_EXECUTABLE_PATH, command] + list(args)
         result = subprocess.run(cmd_list, capture_output=True, text=True, check=True)
@@ -30,6 +72,30 @@ def call_cpp_logic(command, *args):
     except Exception as e:
         return {"status": "error", "message": f"Unexpected error: {str(e)}"}
 
+# --- Request validation helpers ---
+def is_date(value):
+    """True if value has the YYYY-MM-DD shape; the C++ side checks that the date exists."""
+    return isinstance(value, str) and re.fullmatch(r'\d{4}-\d{2}-\d{2}', value, re.ASCII) is not None
+
+def require_date_range():
+    """Reads the required ?from=&to= dates. Returns ([from, to], None), or (None, error response)."""
+    dates = [request.args.get('from'), request.args.get('to')]
+    if not all(is_date(value) for value in dates):
+        return None, (jsonify({"status": "error", "message": "from and to are required. Use YYYY-MM-DD"}), 400)
+    return dates, None
+
+def optional_date_range():
+    """Reads optional ?from=&to= dates as --from/--to arguments. Returns (args, None), or (None, error response)."""
+    args = []
+    for param in ('from', 'to'):
+        value = request.args.get(param)
+        if value is None:
+            continue
+        if not is_date(value):
+            return None, (jsonify({"status": "error", "message": f"Invalid {param} date format. Use YYYY-MM-DD"}), 400)
+        args += ['--' + param, value]
+    return args, None
+
 # --- Flask Routes ---
 
 @app.route('/')
@@ -47,7 +113,7 @@ def mark_attendance_api():
 
     if not isinstance(roll_no, int) or roll_no <= 0:
         return jsonify({"status": "error", "message": "Invalid roll number"}), 400
-    if not isinstance(date, str) or len(date) != 10 or date[4] != '-' or date[7] != '-':
+    if not is_date(date):
         return jsonify({"status": "error", "message": "Invalid date format. Use YYYY-MM-DD"}), 400
 
     result = call_cpp_logic("mark", str(roll_no), date)
@@ -55,6 +121,31 @@ def mark_attendance_api():
         return jsonify(result), 200
     if "already marked" in result.get("message", ""):
         return jsonify(result), 409
+    if result.get("message", "").startswith("Invalid date"):
+        return jsonify(result), 400
+    return jsonify(result), 500
+
+@app.route('/unmark_attendance', methods=['POST'])
+def unmark_attendance_api():
+    data = request.get_json()
+    if not data or 'roll_no' not in data or 'date' not in data:
+        return jsonify({"status": "error", "message": "Missing roll_no or date"}), 400
+
+    roll_no = data['roll_no']
+    date = data['date']
+
+    if not isinstance(roll_no, int) or roll_no <= 0:
+        return jsonify({"status": "error", "message": "Invalid roll number"}), 400
+    if not is_date(date):
+        return jsonify({"status": "error", "message": "Invalid date format. Use YYYY-MM-DD"}), 400
+
+    result = call_cpp_logic("unmark", str(roll_no), date)
+    if result.get("status") == "success":
+        return jsonify(result), 200
+    if "not marked" in result.get("message", ""):
+        return jsonify(result), 404
+    if result.get("message", "").startswith("Invalid date"):
+        return jsonify(result), 400
     return jsonify(result), 500
 
 @app.route('/view_attendance/<int:roll_no>', methods=['GET'])
@@ -62,11 +153,18 @@ def view_attendance_api(roll_no):
     if roll_no <= 0:
         return jsonify({"status": "error", "message": "Invalid roll number"}), 400
 
-    result = call_cpp_logic("view", str(roll_no))
+    # Optional ?from=YYYY-MM-DD&to=YYYY-MM-DD returns only that slice of the history
+    range_args, error = optional_date_range()
+    if error:
+        return error
+
+    result = call_cpp_logic("view", str(roll_no), *range_args)
     if result.get("status") == "success":
         return jsonify(result), 200
     if "not found" in result.get("message", "").lower():
         return jsonify(result), 404
+    if result.get("message", "").startswith("Invalid date"):
+        return jsonify(result), 400
     return jsonify(result), 500
 
 @app.route('/get_overall_stats', methods=['GET'])
@@ -76,6 +174,92 @@ def get_overall_stats_api():
         return jsonify(result), 200
     return jsonify(result), 500
 
+@app.route('/day_attendance/<date>', methods=['GET'])
+def day_attendance_api(date):
+    if not is_date(date):
+        return jsonify({"status": "error", "message": "Invalid date format. Use YYYY-MM-DD"}), 400
+
+    result = call_cpp_logic("day", date)
+    if result.get("status") == "success":
+        return jsonify(result), 200
+    if result.get("message", "").startswith("Invalid date"):
+        return jsonify(result), 400
+    return jsonify(result), 500
+
+@app.route('/attendance_percentage', methods=['GET'])
+def attendance_percentage_api():
+    # Every student's percentage over ?from=YYYY-MM-DD&to=YYYY-MM-DD, against the working-day calendar
+    dates, error = require_date_range()
+    if error:
+        return error
+
+    result = call_cpp_logic("percent", *dates)
+    if result.get("status") == "success":
+        return jsonify(result), 200
+    if result.get("message", "").startswith("Invalid date"):
+        return jsonify(result), 400
+    return jsonify(result), 500
+
+@app.route('/streaks', methods=['GET'])
+def streaks_api():
+    # Absence runs and current streaks over ?from=&to= working days, for everyone or ?roll_no=
+    args, error = require_date_range()
+    if error:
+        return error
+    roll_no = request.args.get('roll_no')
+    if roll_no is not None:
+        if not (roll_no.isascii() and roll_no.isdigit()) or int(roll_no) <= 0:
+            return jsonify({"status": "error", "message": "Invalid roll number"}), 400
+        args.append(roll_no)
+
+    result = call_cpp_logic("streaks", *args)
+    if result.get("status") == "success":
+        return jsonify(result), 200
+    if "not found" in result.get("message", "").lower():
+        return jsonify(result), 404
+    if result.get("message", "").startswith("Invalid date"):
+        return jsonify(result), 400
+    return jsonify(result), 500
+
+def rank_students(command):
+    # Shared by /top_k and /bottom_k: ?k=N with optional ?from=&to= date bounds
+    k = request.args.get('k', '10')
+    if not k.isdigit():
+        return jsonify({"status": "error", "message": "Invalid k"}), 400
+    range_args, error = optional_date_range()
+    if error:
+        return error
+
+    result = call_cpp_logic(command, k, *range_args)
+    if result.get("status") == "success":
+        return jsonify(result), 200
+    if result.get("message", "").startswith("Invalid"):
+        return jsonify(result), 400
+    return jsonify(result), 500
+
+@app.route('/bottom_k', methods=['GET'])
+def bottom_k_api():
+    # The defaulters list: the K students with the fewest marks
+    return rank_students("bottom-k")
+
+@app.route('/top_k', methods=['GET'])
+def top_k_api():
+    return rank_students("top-k")
+
+@app.route('/daily_counts', methods=['GET'])
+def daily_counts_api():
+    # Students present per day over ?from=YYYY-MM-DD&to=YYYY-MM-DD, one count per day
+    dates, error = require_date_range()
+    if error:
+        return error
+
+    result = call_cpp_logic("daily", *dates)
+    if result.get("status") == "success":
+        return jsonify(result), 200
+    if result.get("message", "").startswith("Invalid date"):
+        return jsonify(result), 400
+    return jsonify(result), 500
+
 # --- Main ---
 if __name__ == "__main__":
     print("--- Flask Server for Student Attendance System ---")
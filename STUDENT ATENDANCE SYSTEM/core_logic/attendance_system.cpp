@@ -1,331 +1,3866 @@
 #include <iostream> // For input/output operations (e.g., cout, cin)
-#include <map>      // For std::map (HashMap equivalent)
-#include <vector>   // For std::vector (list of dates)
-#include <string>   // For std::string (dates)
-#include <set>      // For std::set to count unique dates for statistics
+#include <map>      // For std::map (day index, benchmark baseline)
+#include <vector>   // For std::vector (list of day numbers)
+#include <string>   // For std::string (JSON output and date text at the boundary)
 #include <algorithm> // For std::find and std::sort
 #include <sstream>  // For std::stringstream to build JSON strings
 #include <fstream>  // For file operations (ifstream, ofstream)
+#include <cstring>  // For std::strerror and std::strncpy
+#include <cerrno>   // For errno
+#include <csignal>  // For SIGINT/SIGTERM handling in serve mode
+#include <filesystem> // For trimming a torn write-ahead log record
+#include <variant>  // For the two DaySet representations
+#include <cstdint>  // For fixed-width fields of the binary snapshot and day numbers
+#include <cstdlib>  // For std::getenv
+#include <chrono>   // For import throughput timing
+#include <limits>   // For std::numeric_limits
+#include <cstdio>   // For the FILE* handle of the write-ahead log
+#include <thread>   // For sleeping while waiting for the data lock, and the streaks worker threads
+#include <random>   // For synthetic benchmark data
+#include <memory>   // For std::unique_ptr (date dictionary pages)
+#include <string_view> // For borrowed date text from the date dictionary
+#include <iterator> // For std::back_inserter
+#include <memory_resource> // For the pooled allocator of per-student day lists
+#include <queue>    // For the bounded heap of the top-k/bottom-k reports
+#include <cmath>    // For std::round of percentages
+
+#ifndef _WIN32
+#include <fcntl.h>      // For open() of the snapshot file
+#include <sys/mman.h>   // For mmap() of the snapshot file
+#include <sys/stat.h>   // For fstat()
+#include <poll.h>       // For poll() in the serve loop
+#include <sys/socket.h> // For the Unix-domain listening socket
+#include <sys/un.h>     // For sockaddr_un
+#include <unistd.h>     // For read, write, close, unlink, fsync
+#include <sys/file.h>   // For flock() on the data lock file
+#else
+#include <io.h>         // For _open, _commit and _close
+#include <fcntl.h>      // For _O_RDWR and _O_CREAT
+#include <sys/stat.h>   // For _S_IREAD and _S_IWRITE
+#include <sys/locking.h> // For _locking() on the data lock file
+#endif
 
 // Define the filename for persistent storage
 const std::string DATA_FILENAME = "attendance_data.json";
 
-// Define a class to encapsulate the attendance system logic
-class AttendanceSystem {
-private:
-    // Using std::map as a HashMap: roll number (int) -> list of dates (vector of strings)
-    std::map<int, std::vector<std::string>> attendance;
+// Write-ahead log of marks made since the last checkpoint of DATA_FILENAME
+const std::string WAL_FILENAME = "attendance_data.wal";
 
-    /**
-     * @brief Helper to escape strings for JSON output (e.g., handling quotes).
-     * @param s The string to escape.
-     * @return The escaped string.
-     */
-    std::string escape_json_string(const std::string& s) const {
-        std::string escaped_s = "";
-        for (char c : s) {
-            if (c == '"') {
-                escaped_s += "\\\"";
-            } else if (c == '\\') {
-                escaped_s += "\\\\";
-            } else if (c == '\n') {
-                escaped_s += "\\n";
-            } else if (c == '\r') {
-                escaped_s += "\\r";
-            } else if (c == '\t') {
-                escaped_s += "\\t";
-            } else {
-                escaped_s += c;
-            }
+// Number of logged records after which the snapshot is rewritten and the log truncated
+const size_t WAL_CHECKPOINT_RECORDS = 10000;
+
+// Lock file that serializes processes touching the data files (servers, CLI calls, batches)
+const std::string LOCK_FILENAME = "attendance_data.lock";
+
+// How long a command waits for another process to release LOCK_FILENAME
+const int LOCK_TIMEOUT_MS = 5000;
+
+// Default Unix-domain socket used by "attendance_app serve" (relative to the working directory)
+const std::string DEFAULT_SOCKET_PATH = "attendance_app.sock";
+
+// Longest request line serve accepts; a client sending more without a '\n' gets an error and is dropped
+const size_t SERVE_MAX_REQUEST_LINE = 64 * 1024;
+
+// Unsent reply bytes after which serve stops reading a client's requests until it catches up
+const size_t SERVE_MAX_QUEUED_REPLY = 4 * 1024 * 1024;
+
+// Working-day calendar read at startup, one entry per line:
+//   term <start> <end>   every Monday-Friday from start to end (inclusive) is a working day
+//   holiday <date>       not a working day
+//   workday <date>       a working day even though it falls on a weekend or outside a term
+// Blank lines and lines starting with '#' are ignored. Without the file every weekday counts.
+const std::string CALENDAR_FILENAME = "attendance_calendar.txt";
+
+// Binary snapshot written at checkpoints next to DATA_FILENAME; loaded with mmap in preference to the JSON
+const std::string SNAPSHOT_FILENAME = "attendance_data.bin";
+
+// Snapshot layout (host byte order, little-endian on every supported platform):
+//   SnapshotHeader
+//   SnapshotStudent[studentCount]   sorted by roll number
+//   version 2: DayNum[dateCount]    each student's day numbers, sorted (dateWidth == sizeof(DayNum))
+//   version 1: char[dateCount][dateWidth]  each student's ISO dates, sorted, NUL-padded to dateWidth
+const char SNAPSHOT_MAGIC[8] = {'A', 'T', 'T', 'S', 'N', 'A', 'P', '\0'};
+const std::uint32_t SNAPSHOT_VERSION = 2;
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t studentCount;
+    std::uint64_t dateCount;
+    std::uint32_t dateWidth;
+    std::uint32_t reserved;
+};
+
+struct SnapshotStudent {
+    std::int32_t rollNo;
+    std::uint32_t dateCount;
+    std::uint64_t firstDate; // Index of the student's first date in the date array
+};
+
+// A calendar date stored as days since 1970-01-01; covers 1970-01-01 to 2149-06-06.
+// Dates are parsed into day numbers once when they enter the system and are only
+// formatted back to "YYYY-MM-DD" for output.
+typedef std::uint16_t DayNum;
+
+/**
+ * @brief Converts a civil date to days since 1970-01-01 (proleptic Gregorian calendar).
+ */
+long daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const long era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<long>(doe) - 719468;
+}
+
+/**
+ * @brief Parses a strict "YYYY-MM-DD" date into a day number.
+ * @param text The date text.
+ * @param day Receives the day number on success.
+ * @return True if the text is a valid date inside the DayNum range.
+ */
+bool parseDate(const char* text, size_t length, DayNum& day) {
+    if (length != 10 || text[4] != '-' || text[7] != '-') return false;
+    int fields[3] = {0, 0, 0};
+    const int starts[3] = {0, 5, 8}, lengths[3] = {4, 2, 2};
+    for (int f = 0; f < 3; ++f) {
+        for (int i = starts[f]; i < starts[f] + lengths[f]; ++i) {
+            if (text[i] < '0' || text[i] > '9') return false;
+            fields[f] = fields[f] * 10 + (text[i] - '0');
         }
-        return escaped_s;
     }
+    static const int monthDays[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const int year = fields[0], month = fields[1], dom = fields[2];
+    if (month < 1 || month > 12 || dom < 1 || dom > monthDays[month - 1]) return false;
+    if (month == 2 && dom == 29 && !(year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))) return false;
 
-public:
-    // Constructor (optional, can be empty for simple initialization)
-    AttendanceSystem() {
-        // Data will now be loaded from file, so no dummy data here.
-    }
+    const long days = daysFromCivil(year, month, dom);
+    if (days < 0 || days > 0xFFFF) return false;
+    day = static_cast<DayNum>(days);
+    return true;
+}
 
+bool parseDate(const std::string& text, DayNum& day) {
+    return parseDate(text.data(), text.size(), day);
+}
+
+/**
+ * @brief Formats a day number as "YYYY-MM-DD".
+ */
+std::string formatDate(DayNum dayNum) {
+    // Inverse of daysFromCivil (days are never negative here)
+    const long z = static_cast<long>(dayNum) + 719468;
+    const long era = z / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    const unsigned year = static_cast<unsigned>(yoe + era * 400 + (month <= 2));
+
+    char text[10] = {char('0' + year / 1000), char('0' + year / 100 % 10), char('0' + year / 10 % 10), char('0' + year % 10), '-',
+                     char('0' + month / 10), char('0' + month % 10), '-', char('0' + day / 10), char('0' + day % 10)};
+    return std::string(text, sizeof(text));
+}
+
+/**
+ * @brief Process-wide dictionary of date text, one entry per distinct day.
+ *
+ * Dates are stored everywhere as DayNum, a 2-byte ID shared by all students, so
+ * the only per-occurrence string work left is formatting them back to text on
+ * output. The dictionary formats each distinct day once and hands out views of
+ * that text afterwards. Entries live in 256-day pages allocated on first use,
+ * so a few terms of dates cost a few kilobytes; the text is never freed or
+ * moved, so views stay valid for the life of the process.
+ */
+class DateDictionary {
+private:
+    static const int DATE_TEXT_LENGTH = 10; // "YYYY-MM-DD"
+
+    struct Page {
+        char text[256][DATE_TEXT_LENGTH];
+        std::uint64_t present[4] = {0, 0, 0, 0}; // Bit per day: text has been filled in
+    };
+
+    static inline std::unique_ptr<Page> pages[256];
+
+public:
     /**
-     * @brief Loads attendance data from a JSON file.
-     * @return True if data was loaded successfully, false otherwise.
+     * @brief Returns the "YYYY-MM-DD" text of a day, formatting it on first use.
      */
-    bool loadData() {
-        std::ifstream inFile(DATA_FILENAME);
-        if (!inFile.is_open()) {
-            // File doesn't exist or cannot be opened, which is fine for first run.
-            // std::cerr << "Warning: Could not open " << DATA_FILENAME << " for reading. Starting with empty data." << std::endl;
-            return false;
+    static std::string_view text(DayNum day) {
+        std::unique_ptr<Page>& page = pages[day >> 8];
+        if (!page) page.reset(new Page());
+        const unsigned offset = day & 0xFF;
+        const std::uint64_t mask = std::uint64_t(1) << (offset % 64);
+        if (!(page->present[offset / 64] & mask)) {
+            const std::string formatted = formatDate(day);
+            std::memcpy(page->text[offset], formatted.data(), DATE_TEXT_LENGTH);
+            page->present[offset / 64] |= mask;
         }
+        return std::string_view(page->text[offset], DATE_TEXT_LENGTH);
+    }
 
-        std::stringstream buffer;
-        buffer << inFile.rdbuf();
-        std::string json_str = buffer.str();
-        inFile.close();
+    /**
+     * @brief Bytes held by the pages allocated so far.
+     */
+    static size_t bytes() {
+        size_t allocated = 0;
+        for (const std::unique_ptr<Page>& page : pages) allocated += page ? sizeof(Page) : 0;
+        return allocated;
+    }
+};
 
-        if (json_str.empty()) {
-            return false; // Empty file
-        }
+/**
+ * @brief Counts the set bits of a 64-bit word.
+ */
+inline int popcount64(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for (; word; word &= word - 1) ++count;
+    return count;
+#endif
+}
 
-        // Simple JSON parsing (for demonstration purposes, a full JSON library would be better)
-        // Expected format: {"101":["2025-07-01","2025-07-02"], "102":["2025-07-01"]}
-        try {
-            // Remove outer braces
-            if (json_str.length() < 2 || json_str.front() != '{' || json_str.back() != '}') {
-                std::cerr << "Error: Invalid JSON format in " << DATA_FILENAME << std::endl;
-                return false;
-            }
-            json_str = json_str.substr(1, json_str.length() - 2);
+/**
+ * @brief Index of the lowest set bit of a non-zero 64-bit word.
+ */
+inline int ctz64(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int index = 0;
+    while (!(word & 1)) { word >>= 1; ++index; }
+    return index;
+#endif
+}
 
-            std::stringstream ss(json_str);
-            std::string segment;
-            // Iterate through key-value pairs separated by commas, but be careful with nested commas in arrays
-            // This simple parser assumes no commas within date strings and no complex nesting.
-            // A robust JSON parser (like nlohmann/json) is highly recommended for real applications.
-            size_t start = 0;
-            size_t end = 0;
-            int brace_count = 0;
-            int bracket_count = 0;
+/**
+ * @brief Index of the highest set bit of a non-zero 64-bit word.
+ */
+inline int highBit64(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(word);
+#else
+    int index = 63;
+    while (!(word >> 63)) { word <<= 1; --index; }
+    return index;
+#endif
+}
 
-            for (size_t i = 0; i < json_str.length(); ++i) {
-                if (json_str[i] == '{') brace_count++;
-                else if (json_str[i] == '}') brace_count--;
-                else if (json_str[i] == '[') bracket_count++;
-                else if (json_str[i] == ']') bracket_count--;
+// Days covered by one term bitset: 256 bits, i.e. 32 bytes per student
+const int TERM_DAYS = 256;
 
-                if (json_str[i] == ',' && brace_count == 0 && bracket_count == 0) {
-                    segment = json_str.substr(start, i - start);
-                    start = i + 1;
+struct TermBits {
+    std::uint64_t words[TERM_DAYS / 64] = {};
+};
 
-                    size_t colon_pos = segment.find(':');
-                    if (colon_pos == std::string::npos) continue;
+/**
+ * @brief The set of days one student was present.
+ *
+ * By default this is a sorted vector of day numbers. When a term is configured
+ * (attendance_app --term <start> ...), new sets are fixed-size bitsets indexed
+ * by the day offset from the term start instead: a duplicate check is one bit
+ * test and the count is a popcount. A set that receives a day outside the term
+ * converts itself back to the vector form, so no data is ever dropped.
+ */
+class DaySet {
+private:
+    typedef std::pmr::vector<DayNum> DayList;
+    std::variant<TermBits, DayList> days;
 
-                    std::string key_str = segment.substr(0, colon_pos);
-                    std::string value_str = segment.substr(colon_pos + 1);
+    // Start of the configured term, or -1 when bitsets are disabled (process-wide)
+    static inline long termStart = -1;
 
-                    // Extract roll number (remove quotes if present)
-                    if (key_str.length() >= 2 && key_str.front() == '"' && key_str.back() == '"') {
-                        key_str = key_str.substr(1, key_str.length() - 2);
-                    }
-                    int rollNo = std::stoi(key_str);
+    static bool inTerm(DayNum day) {
+        return termStart >= 0 && day >= termStart && day < termStart + TERM_DAYS;
+    }
 
-                    // Extract dates array (remove brackets and quotes)
-                    if (value_str.length() >= 2 && value_str.front() == '[' && value_str.back() == ']') {
-                        value_str = value_str.substr(1, value_str.length() - 2);
-                    } else {
-                        continue; // Not a valid array
-                    }
+    /**
+     * @brief Switches a bitset to the sorted vector form, allocated from resource.
+     */
+    DayList& toList(std::pmr::memory_resource* resource) {
+        if (std::holds_alternative<TermBits>(days)) {
+            DayList list(resource);
+            list.reserve(size());
+            forEach([&list](DayNum day) { list.push_back(day); });
+            days = std::move(list);
+        }
+        return std::get<DayList>(days);
+    }
 
-                    std::stringstream date_ss(value_str);
-                    std::string date_segment;
-                    while (std::getline(date_ss, date_segment, ',')) {
-                        // Remove quotes from date and trim whitespace
-                        date_segment.erase(0, date_segment.find_first_not_of(" \t\n\r\f\v"));
-                        date_segment.erase(date_segment.find_last_not_of(" \t\n\r\f\v") + 1);
-                        if (date_segment.length() >= 2 && date_segment.front() == '"' && date_segment.back() == '"') {
-                            date_segment = date_segment.substr(1, date_segment.length() - 2);
-                        }
-                        attendance[rollNo].push_back(date_segment);
-                    }
-                    std::sort(attendance[rollNo].begin(), attendance[rollNo].end()); // Ensure loaded dates are sorted
-                }
-            }
-            // Process the last segment
-            segment = json_str.substr(start);
-            size_t colon_pos = segment.find(':');
-            if (colon_pos != std::string::npos) {
-                std::string key_str = segment.substr(0, colon_pos);
-                std::string value_str = segment.substr(colon_pos + 1);
+public:
+    DaySet() : DaySet(std::pmr::get_default_resource()) {}
 
-                if (key_str.length() >= 2 && key_str.front() == '"' && key_str.back() == '"') {
-                    key_str = key_str.substr(1, key_str.length() - 2);
-                }
-                int rollNo = std::stoi(key_str);
+    /**
+     * @param resource The resource the set's day list allocates from.
+     */
+    explicit DaySet(std::pmr::memory_resource* resource) {
+        if (termStart < 0) days.emplace<DayList>(resource);
+    }
 
-                if (value_str.length() >= 2 && value_str.front() == '[' && value_str.back() == ']') {
-                    value_str = value_str.substr(1, value_str.length() - 2);
-                }
+    /**
+     * @brief Enables bitset storage for sets created from now on.
+     * @param start First day of the term; the term covers TERM_DAYS days.
+     */
+    static void setTerm(DayNum start) {
+        termStart = start;
+    }
 
-                std::stringstream date_ss(value_str);
-                std::string date_segment;
-                while (std::getline(date_ss, date_segment, ',')) {
-                    date_segment.erase(0, date_segment.find_first_not_of(" \t\n\r\f\v"));
-                    date_segment.erase(date_segment.find_last_not_of(" \t\n\r\f\v") + 1);
-                    if (date_segment.length() >= 2 && date_segment.front() == '"' && date_segment.back() == '"') {
-                        date_segment = date_segment.substr(1, date_segment.length() - 2);
-                    }
-                    attendance[rollNo].push_back(date_segment);
-                }
-                std::sort(attendance[rollNo].begin(), attendance[rollNo].end());
+    /**
+     * @brief Adds a day to the set.
+     * @param resource Allocates the day list if a bitset has to switch to the list form.
+     * @return True if the day was added, false if it was already present.
+     */
+    bool insert(DayNum day, std::pmr::memory_resource* resource) {
+        if (auto* bits = std::get_if<TermBits>(&days)) {
+            if (inTerm(day)) {
+                const unsigned offset = day - termStart;
+                std::uint64_t& word = bits->words[offset / 64];
+                const std::uint64_t mask = std::uint64_t(1) << (offset % 64);
+                if (word & mask) return false;
+                word |= mask;
+                return true;
             }
-
+        }
+        DayList& list = toList(resource);
+        if (list.empty() || list.back() < day) {
+            list.push_back(day); // Common case: the newest date so far, amortized O(1)
             return true;
-        } catch (const std::exception& e) {
-            std::cerr << "Error parsing JSON from " << DATA_FILENAME << ": " << e.what() << std::endl;
-            attendance.clear(); // Clear potentially corrupted data
+        }
+        // Otherwise binary search for the position that keeps the list sorted
+        auto it = std::lower_bound(list.begin(), list.end(), day);
+        if (*it == day) {
             return false;
         }
+        list.insert(it, day);
+        return true;
     }
 
     /**
-     * @brief Saves attendance data to a JSON file.
-     * @return True if data was saved successfully, false otherwise.
+     * @brief Removes a day from the set.
+     * @return True if the day was removed, false if it was not present.
      */
-    bool saveData() const {
-        std::ofstream outFile(DATA_FILENAME);
-        if (!outFile.is_open()) {
-            std::cerr << "Error: Could not open " << DATA_FILENAME << " for writing." << std::endl;
-            return false;
+    bool erase(DayNum day) {
+        if (auto* bits = std::get_if<TermBits>(&days)) {
+            if (!inTerm(day)) return false;
+            const unsigned offset = day - termStart;
+            std::uint64_t& word = bits->words[offset / 64];
+            const std::uint64_t mask = std::uint64_t(1) << (offset % 64);
+            if (!(word & mask)) return false;
+            word &= ~mask;
+            return true;
         }
+        DayList& list = std::get<DayList>(days);
+        auto it = std::lower_bound(list.begin(), list.end(), day);
+        if (it == list.end() || *it != day) return false;
+        list.erase(it);
+        return true;
+    }
 
-        outFile << "{";
-        bool first_student = true;
-        for (const auto& pair : attendance) {
-            if (!first_student) {
-                outFile << ",";
-            }
-            outFile << "\"" << pair.first << "\":["; // Roll number as string key
-            bool first_date = true;
-            for (const std::string& date : pair.second) {
-                if (!first_date) {
-                    outFile << ",";
-                }
-                outFile << "\"" << escape_json_string(date) << "\""; // Escape and quote date
-                first_date = false;
+    /**
+     * @brief Adds a run of days that is already sorted (bulk load path).
+     * Repeated days are dropped, as insert() would.
+     */
+    void insertSorted(const DayNum* first, size_t count, std::pmr::memory_resource* resource) {
+        auto* list = std::get_if<DayList>(&days);
+        if (list && list->empty()) {
+            list->reserve(count);
+            std::unique_copy(first, first + count, std::back_inserter(*list));
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            insert(first[i], resource);
+        }
+    }
+
+    /**
+     * @brief Heap bytes held by the set (the bitset form lives inline).
+     */
+    size_t heapBytes() const {
+        const DayList* list = std::get_if<DayList>(&days);
+        return list ? list->capacity() * sizeof(DayNum) : 0;
+    }
+
+    /**
+     * @brief Repacks the set into its smallest form: a bitset when every day falls
+     * in the configured term, otherwise a list with no spare capacity, allocated
+     * from resource.
+     */
+    void compact(std::pmr::memory_resource* resource) {
+        DayList* list = std::get_if<DayList>(&days);
+        if (!list) return;
+        if (termStart >= 0 && (list->empty() || (inTerm(list->front()) && inTerm(list->back())))) {
+            TermBits bits;
+            for (DayNum day : *list) {
+                const unsigned offset = day - termStart;
+                bits.words[offset / 64] |= std::uint64_t(1) << (offset % 64);
             }
-            outFile << "]";
-            first_student = false;
+            days = bits;
+            return;
         }
-        outFile << "}";
-        outFile.close();
-        return true;
+        DayList packed(resource);
+        packed.reserve(list->size());
+        packed.assign(list->begin(), list->end());
+        days.emplace<DayList>(std::move(packed)); // Move-constructs, so the list keeps the new resource
     }
 
     /**
-     * @brief Marks attendance for a given student on a specific date.
-     * @param rollNo The roll number of the student.
-     * @param date The date to mark attendance (e.g., "YYYY-MM-DD").
-     * @return A JSON string indicating success or error.
+     * @brief Number of days in the set.
      */
-    std::string markAttendance(int rollNo, const std::string& date) {
-        // Check if the student already has attendance marked for this date
-        // Use std::find to check if the date already exists in the vector
-        if (std::find(attendance[rollNo].begin(), attendance[rollNo].end(), date) == attendance[rollNo].end()) {
-            attendance[rollNo].push_back(date); // Add the date
-            std::sort(attendance[rollNo].begin(), attendance[rollNo].end()); // Keep dates sorted
-            return "{\"status\": \"success\", \"message\": \"Attendance marked for Roll No: " + std::to_string(rollNo) + " on " + date + "\"}";
-        } else {
-            return "{\"status\": \"error\", \"message\": \"Attendance already marked for Roll No: " + std::to_string(rollNo) + " on " + date + "\"}";
+    size_t size() const {
+        if (auto* bits = std::get_if<TermBits>(&days)) {
+            size_t count = 0;
+            for (std::uint64_t word : bits->words) count += popcount64(word);
+            return count;
         }
+        return std::get<DayList>(days).size();
     }
 
     /**
-     * @brief Views all marked attendance dates for a specific student.
-     * @param rollNo The roll number of the student.
-     * @return A JSON string with attendance data or an error message.
+     * @brief Calls fn(day) for every day in ascending order.
      */
-    std::string viewAttendance(int rollNo) const {
-        // Check if the roll number exists in the map
-        auto it = attendance.find(rollNo);
-        if (it != attendance.end()) {
-            std::stringstream ss;
-            ss << "{\"status\": \"success\", \"roll_no\": " << rollNo << ", \"dates\": [";
-            for (size_t i = 0; i < it->second.size(); ++i) {
-                ss << "\"" << escape_json_string(it->second[i]) << "\""; // Enclose dates in quotes for JSON string
-                if (i < it->second.size() - 1) {
-                    ss << ", ";
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        if (auto* bits = std::get_if<TermBits>(&days)) {
+            for (int w = 0; w < TERM_DAYS / 64; ++w) {
+                for (std::uint64_t word = bits->words[w]; word; word &= word - 1) {
+                    fn(static_cast<DayNum>(termStart + w * 64 + ctz64(word)));
                 }
             }
-            ss << "]}";
-            return ss.str();
-        } else {
-            return "{\"status\": \"error\", \"message\": \"Roll No: " + std::to_string(rollNo) + " not found.\"}";
+            return;
         }
+        for (DayNum day : std::get<DayList>(days)) fn(day);
     }
 
     /**
-     * @brief Calculates and returns overall attendance statistics.
-     * @return A JSON string containing statistics.
+     * @brief Number of days in [from, to]: two binary searches on the list form,
+     * masked popcounts on the bitset form.
      */
-    std::string getOverallStats() const {
-        int totalStudents = attendance.size(); // Number of unique roll numbers
-
-        int totalAttendanceEntries = 0;
-        std::set<std::string> uniqueDates; // Use a set to count unique dates across all students
-
-        for (const auto& pair : attendance) {
-            totalAttendanceEntries += pair.second.size(); // Sum of all attendance marks
-            for (const std::string& date : pair.second) {
-                uniqueDates.insert(date); // Add date to set to count unique days
+    size_t countInRange(DayNum from, DayNum to) const {
+        if (from > to) return 0;
+        if (auto* bits = std::get_if<TermBits>(&days)) {
+            const long first = std::max<long>(from, termStart);
+            const long last = std::min<long>(to, termStart + TERM_DAYS - 1);
+            size_t count = 0;
+            for (long w = 0; first <= last && w < TERM_DAYS / 64; ++w) {
+                const long wordFirst = termStart + w * 64;
+                if (wordFirst > last || wordFirst + 63 < first) continue;
+                std::uint64_t word = bits->words[w];
+                if (first > wordFirst) word &= ~std::uint64_t(0) << (first - wordFirst);
+                if (last < wordFirst + 63) word &= (std::uint64_t(1) << (last - wordFirst + 1)) - 1;
+                count += popcount64(word);
             }
+            return count;
         }
+        const DayList& list = std::get<DayList>(days);
+        auto first = std::lower_bound(list.begin(), list.end(), from);
+        return static_cast<size_t>(std::upper_bound(first, list.end(), to) - first);
+    }
 
-        std::stringstream ss;
-        ss << "{\"status\": \"success\", \"stats\": {";
-        ss << "\"total_students\": " << totalStudents << ", ";
-        ss << "\"total_unique_dates\": " << uniqueDates.size() << ", ";
-        ss << "\"total_attendance_entries\": " << totalAttendanceEntries;
-        ss << "}}";
-        return ss.str();
+    /**
+     * @brief Calls fn(day) for every day in [from, to] in ascending order.
+     * The list form binary searches for the slice and the bitset form only reads
+     * the words that overlap the range, so the cost follows the range, not the history.
+     */
+    template <typename Fn>
+    void forEachInRange(DayNum from, DayNum to, Fn fn) const {
+        if (from > to) return;
+        if (auto* bits = std::get_if<TermBits>(&days)) {
+            const long first = std::max<long>(from, termStart);
+            const long last = std::min<long>(to, termStart + TERM_DAYS - 1);
+            if (first > last) return;
+            const unsigned lo = static_cast<unsigned>(first - termStart);
+            const unsigned hi = static_cast<unsigned>(last - termStart);
+            for (unsigned w = lo / 64; w <= hi / 64; ++w) {
+                std::uint64_t word = bits->words[w];
+                if (w == lo / 64) word &= ~std::uint64_t(0) << (lo % 64);
+                if (w == hi / 64 && hi % 64 != 63) word &= (std::uint64_t(1) << (hi % 64 + 1)) - 1;
+                for (; word; word &= word - 1) {
+                    fn(static_cast<DayNum>(termStart + w * 64 + ctz64(word)));
+                }
+            }
+            return;
+        }
+        const DayList& list = std::get<DayList>(days);
+        auto it = std::lower_bound(list.begin(), list.end(), from);
+        auto end = std::upper_bound(it, list.end(), to);
+        for (; it != end; ++it) fn(*it);
     }
 };
 
-// Main function now acts as a command-line interface for the Flask app
-int main(int argc, char* argv[]) {
-    // This static instance will persist data across calls within the same process
-    // For a real-world scenario, you'd use a database or persistent storage.
-    static AttendanceSystem system;
+/**
+ * @brief Index from roll number to a dense slot number.
+ *
+ * Roll numbers are usually small dense integers (1..N per batch), so the index
+ * starts in direct mode: a plain array indexed by (rollNo - base), where a
+ * lookup is one bounds check and one load. The first roll number that would
+ * make that array too sparse (more than DENSE_FACTOR times the student count,
+ * plus some slack) switches it to an open-addressing hash table: keys and slots
+ * side by side in one flat power-of-two array, probed linearly. Either way
+ * there is no per-entry allocation. Students are only removed when their first
+ * mark is undone, and a removal re-inserts the rest of its probe cluster, so
+ * there are no tombstones.
+ */
+class RollIndex {
+private:
+    struct Entry {
+        std::int32_t rollNo;
+        std::uint32_t slot; // EMPTY_SLOT when the entry is unused
+    };
+    static constexpr std::uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+    static constexpr size_t DENSE_FACTOR = 4;    // Direct array may be up to 4x the student count...
+    static constexpr size_t DENSE_SLACK = 1024;  // ...plus this many unused slots
 
-    // Load data at the beginning of each execution
-    system.loadData();
+    bool dense = true;
+    long long base = 0;                 // Roll number of direct[0]
+    long long lowest = 0, highest = 0;  // Direct mode: smallest and largest roll number indexed
+    std::vector<std::uint32_t> direct;  // Direct mode: slot per roll number offset
+    std::vector<Entry> table;           // Hash mode: the open-addressing table
+    size_t count = 0;
+    unsigned shift = 64; // 64 - log2(table.size())
 
-    // Check for minimum arguments (command name)
-    if (argc < 2) {
-        std::cout << "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app <command> [args]\"}" << std::endl;
-        return 1; // Indicate error
+    size_t bucketOf(int rollNo) const {
+        // Fibonacci hashing spreads consecutive roll numbers across the table
+        return static_cast<size_t>((static_cast<std::uint64_t>(static_cast<std::uint32_t>(rollNo)) * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Entry> old;
+        old.swap(table);
+        table.assign(capacity, Entry{0, EMPTY_SLOT});
+        shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) --shift;
+        for (const Entry& entry : old) {
+            if (entry.slot != EMPTY_SLOT) insertHashed(entry);
+        }
     }
 
-    std::string command = argv[1]; // The first argument is the command (e.g., "mark", "view", "stats")
-    std::string result_json; // To store the JSON output from the function calls
+    void insertHashed(const Entry& entry) {
+        size_t i = bucketOf(entry.rollNo);
+        while (table[i].slot != EMPTY_SLOT) i = (i + 1) & (table.size() - 1);
+        table[i] = entry;
+    }
 
-    if (command == "mark") {
-        // Expects: ./attendance_app mark <roll_no> <date>
-        if (argc != 4) {
-            result_json = "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app mark <roll_no> <date>\"}";
+    /**
+     * @brief Tries to make room for rollNo in the direct array.
+     * @return False if that would make the array too sparse.
+     */
+    bool growDirect(int rollNo) {
+        const long long low = count == 0 ? rollNo : std::min<long long>(lowest, rollNo);
+        const long long high = count == 0 ? rollNo : std::max<long long>(highest, rollNo);
+        const unsigned long long span = static_cast<unsigned long long>(high - low) + 1;
+        const unsigned long long limit = (count + 1) * DENSE_FACTOR + DENSE_SLACK;
+        if (span > limit) return false;
+
+        if (direct.empty() || low < base) {
+            // Rebase downwards, leaving as much headroom below as the array already holds
+            // (resize() does the same above), so descending roll numbers cost amortized O(1)
+            const long long end = direct.empty() ? high + 1 : base + static_cast<long long>(direct.size());
+            const unsigned long long headroom = std::min<unsigned long long>(direct.size(), limit - span);
+            const long long newBase = std::max<long long>(low - static_cast<long long>(headroom), std::numeric_limits<std::int32_t>::min());
+            std::vector<std::uint32_t> rebased(static_cast<size_t>(end - newBase), EMPTY_SLOT);
+            if (!direct.empty()) std::copy(direct.begin(), direct.end(), rebased.begin() + (base - newBase));
+            direct.swap(rebased);
+            base = newBase;
+        }
+        if (high - base >= static_cast<long long>(direct.size())) {
+            direct.resize(static_cast<size_t>(high - base) + 1, EMPTY_SLOT);
+        }
+        lowest = low;
+        highest = high;
+        return true;
+    }
+
+    /**
+     * @brief Moves every entry of the direct array into a hash table.
+     */
+    void switchToHash() {
+        dense = false;
+        size_t capacity = 16;
+        while (capacity * 7 < (count + 1) * 10) capacity *= 2;
+        table.assign(capacity, Entry{0, EMPTY_SLOT});
+        shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) --shift;
+        for (size_t i = 0; i < direct.size(); ++i) {
+            if (direct[i] != EMPTY_SLOT) insertHashed(Entry{static_cast<std::int32_t>(base + static_cast<long long>(i)), direct[i]});
+        }
+        std::vector<std::uint32_t>().swap(direct);
+    }
+
+public:
+    static constexpr std::uint32_t NOT_FOUND = EMPTY_SLOT;
+
+    /**
+     * @brief Returns the slot of a roll number, or NOT_FOUND.
+     */
+    std::uint32_t find(int rollNo) const {
+        if (dense) {
+            const unsigned long long offset = static_cast<unsigned long long>(static_cast<long long>(rollNo) - base);
+            return offset < direct.size() ? direct[offset] : NOT_FOUND;
+        }
+        for (size_t i = bucketOf(rollNo);; i = (i + 1) & (table.size() - 1)) {
+            const Entry& entry = table[i];
+            if (entry.slot == EMPTY_SLOT) return NOT_FOUND;
+            if (entry.rollNo == rollNo) return entry.slot;
+        }
+    }
+
+    /**
+     * @brief Adds a roll number that is not in the index yet.
+     */
+    void insert(int rollNo, std::uint32_t slot) {
+        if (dense && !growDirect(rollNo)) {
+            switchToHash(); // Roll numbers are too sparse for direct indexing
+        }
+        if (dense) {
+            direct[static_cast<size_t>(rollNo - base)] = slot;
         } else {
-            try {
-                int rollNo = std::stoi(argv[2]); // Convert string argument to integer
-                std::string date = argv[3];
-                result_json = system.markAttendance(rollNo, date);
-                // Save data after modification
-                system.saveData();
-            } catch (const std::exception& e) {
-                result_json = "{\"status\": \"error\", \"message\": \"Invalid roll number or date format: " + std::string(e.what()) + "\"}";
+            if ((count + 1) * 10 > table.size() * 7) { // Keep the load factor under 0.7
+                rehash(table.size() * 2);
             }
+            insertHashed(Entry{rollNo, slot});
         }
-    } else if (command == "view") {
-        // Expects: ./attendance_app view <roll_no>
-        if (argc != 3) {
-            result_json = "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app view <roll_no>\"}";
+        ++count;
+    }
+
+    /**
+     * @brief Removes a roll number, if present.
+     * Direct mode keeps its range; hash mode re-inserts the entries after it in
+     * the same probe cluster, so later lookups do not stop at the gap.
+     */
+    void erase(int rollNo) {
+        if (dense) {
+            const unsigned long long offset = static_cast<unsigned long long>(static_cast<long long>(rollNo) - base);
+            if (offset >= direct.size() || direct[offset] == EMPTY_SLOT) return;
+            direct[offset] = EMPTY_SLOT;
         } else {
-            try {
-                int rollNo = std::stoi(argv[2]);
-                result_json = system.viewAttendance(rollNo);
-            } catch (const std::exception& e) {
-                result_json = "{\"status\": \"error\", \"message\": \"Invalid roll number format: " + std::string(e.what()) + "\"}";
+            size_t i = bucketOf(rollNo);
+            while (table[i].slot != EMPTY_SLOT && table[i].rollNo != rollNo) i = (i + 1) & (table.size() - 1);
+            if (table[i].slot == EMPTY_SLOT) return;
+            table[i].slot = EMPTY_SLOT;
+            for (i = (i + 1) & (table.size() - 1); table[i].slot != EMPTY_SLOT; i = (i + 1) & (table.size() - 1)) {
+                const Entry moved = table[i];
+                table[i].slot = EMPTY_SLOT;
+                insertHashed(moved);
             }
         }
-    } else if (command == "stats") {
-        // Expects: ./attendance_app stats
-        if (argc != 2) {
-            result_json = "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app stats\"}";
+        --count;
+    }
+
+    /**
+     * @brief Sizes the hash table for n roll numbers up front (direct mode sizes itself from the range).
+     */
+    void reserve(size_t n) {
+        if (dense) return;
+        size_t capacity = 16;
+        while (capacity * 7 < n * 10) capacity *= 2;
+        if (capacity > table.size()) rehash(capacity);
+    }
+
+    /**
+     * @brief Bytes held by the direct array or hash table.
+     */
+    size_t bytes() const {
+        return direct.capacity() * sizeof(std::uint32_t) + table.capacity() * sizeof(Entry);
+    }
+
+    /**
+     * @brief Rebuilds the index at its smallest size, going back to direct mode
+     * when the roll numbers form a dense enough range.
+     */
+    void compact() {
+        std::vector<Entry> entries;
+        entries.reserve(count);
+        for (size_t i = 0; i < direct.size(); ++i) {
+            if (direct[i] != EMPTY_SLOT) entries.push_back(Entry{static_cast<std::int32_t>(base + static_cast<long long>(i)), direct[i]});
+        }
+        for (const Entry& entry : table) {
+            if (entry.slot != EMPTY_SLOT) entries.push_back(entry);
+        }
+        clear();
+        std::vector<std::uint32_t>().swap(direct);
+        std::vector<Entry>().swap(table);
+        if (entries.empty()) return;
+
+        auto range = std::minmax_element(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.rollNo < b.rollNo; });
+        const long long low = range.first->rollNo;
+        const unsigned long long span = static_cast<unsigned long long>(range.second->rollNo - low) + 1;
+        if (span <= entries.size() * DENSE_FACTOR + DENSE_SLACK) {
+            base = lowest = low;
+            highest = range.second->rollNo;
+            direct.assign(static_cast<size_t>(span), EMPTY_SLOT);
+            for (const Entry& entry : entries) direct[static_cast<size_t>(entry.rollNo - base)] = entry.slot;
         } else {
-            result_json = system.getOverallStats();
+            dense = false;
+            size_t capacity = 16;
+            while (capacity * 7 < entries.size() * 10) capacity *= 2;
+            rehash(capacity);
+            for (const Entry& entry : entries) insertHashed(entry);
+        }
+        count = entries.size();
+    }
+
+    void clear() {
+        dense = true;
+        base = lowest = highest = 0;
+        direct.clear();
+        table.clear();
+        count = 0;
+        shift = 64;
+    }
+};
+
+/**
+ * @brief All students' day sets, stored contiguously and indexed by roll number.
+ *
+ * Roll numbers and day sets are kept in parallel vectors in arrival order
+ * (a student's position is its slot); the RollIndex maps a roll number to
+ * its slot, directly for dense roll ranges and by hashing otherwise. Full
+ * scans walk the vectors linearly. Code that needs roll number order (saving,
+ * building the day index) asks for rollOrder(). Every day list allocates from
+ * the memory resource the table was given.
+ */
+class StudentTable {
+private:
+    std::vector<int> rollNos;
+    std::vector<DaySet> daySets;
+    RollIndex index;
+    std::pmr::memory_resource* resource;
+
+    /**
+     * @brief Returns the day set of a student, registering the student if needed.
+     */
+    DaySet& slotFor(int rollNo) {
+        std::uint32_t slot = index.find(rollNo);
+        if (slot == RollIndex::NOT_FOUND) {
+            slot = static_cast<std::uint32_t>(rollNos.size());
+            rollNos.push_back(rollNo);
+            daySets.emplace_back(resource);
+            index.insert(rollNo, slot);
+        }
+        return daySets[slot];
+    }
+
+public:
+    explicit StudentTable(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : resource(resource) {}
+
+    /**
+     * @brief Adds a day to a student's set, registering the student if needed.
+     * @return True if the day was added, false if it was already present.
+     */
+    bool insert(int rollNo, DayNum day) {
+        return slotFor(rollNo).insert(day, resource);
+    }
+
+    /**
+     * @brief Adds a sorted run of days to a student's set, registering the student if needed.
+     */
+    void insertSorted(int rollNo, const DayNum* first, size_t count) {
+        slotFor(rollNo).insertSorted(first, count, resource);
+    }
+
+    /**
+     * @brief Unregisters the most recently registered student.
+     * Only for undoing that student's first mark, so its day set is empty.
+     */
+    void removeLast() {
+        index.erase(rollNos.back());
+        rollNos.pop_back();
+        daySets.pop_back();
+    }
+
+    /**
+     * @brief Returns the day set of a student, or nullptr if the student is unknown.
+     */
+    DaySet* find(int rollNo) {
+        std::uint32_t slot = index.find(rollNo);
+        return slot == RollIndex::NOT_FOUND ? nullptr : &daySets[slot];
+    }
+
+    const DaySet* find(int rollNo) const {
+        std::uint32_t slot = index.find(rollNo);
+        return slot == RollIndex::NOT_FOUND ? nullptr : &daySets[slot];
+    }
+
+    /**
+     * @brief Returns the slot of a student, or RollIndex::NOT_FOUND.
+     */
+    std::uint32_t slotOf(int rollNo) const { return index.find(rollNo); }
+
+    size_t size() const { return rollNos.size(); }
+    int rollAt(size_t slot) const { return rollNos[slot]; }
+    const DaySet& daysAt(size_t slot) const { return daySets[slot]; }
+
+    /**
+     * @brief Slots ordered by roll number.
+     */
+    std::vector<std::uint32_t> rollOrder() const {
+        std::vector<std::uint32_t> order(rollNos.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<std::uint32_t>(i);
+        if (!std::is_sorted(rollNos.begin(), rollNos.end())) {
+            std::sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) { return rollNos[a] < rollNos[b]; });
+        }
+        return order;
+    }
+
+    void reserve(size_t n) {
+        rollNos.reserve(n);
+        daySets.reserve(n);
+        index.reserve(n);
+    }
+
+    size_t indexBytes() const { return index.bytes(); }
+
+    /**
+     * @brief Bytes of the per-student slots: roll numbers and DaySet headers.
+     */
+    size_t slotBytes() const {
+        return rollNos.capacity() * sizeof(int) + daySets.capacity() * sizeof(DaySet);
+    }
+
+    /**
+     * @brief Heap bytes of all students' day lists.
+     */
+    size_t dayBytes() const {
+        size_t bytes = 0;
+        for (const DaySet& days : daySets) bytes += days.heapBytes();
+        return bytes;
+    }
+
+    /**
+     * @brief Repacks every day set and drops all spare capacity.
+     * @param target The resource day lists move to, and allocate from afterwards.
+     */
+    void compact(std::pmr::memory_resource* target) {
+        resource = target;
+        for (DaySet& days : daySets) days.compact(resource);
+        rollNos.shrink_to_fit();
+        daySets.shrink_to_fit();
+        index.compact();
+    }
+
+    void clear() {
+        rollNos.clear();
+        daySets.clear();
+        index.clear();
+    }
+};
+
+/**
+ * @brief Compressed set of roll numbers, organised like a roaring bitmap.
+ *
+ * A roll number is split into a 16-bit high part, which selects a container,
+ * and a 16-bit low part stored in it. Each container picks the smallest of
+ * three forms: a sorted array of low parts (up to ARRAY_MAX entries), a 65536
+ * bit bitmap, or a list of runs [start, last]. Dense per-day sets of a large
+ * campus end up as bitmaps or runs, sparse ones as arrays, and AND/OR/ANDNOT
+ * work container by container, so a whole-campus intersection touches at most
+ * a few kilobytes per 65536 roll numbers. Run containers are only produced by
+ * runOptimize(); mutating one turns it back into an array or bitmap first.
+ */
+class RollBitmap {
+private:
+    enum Kind : std::uint8_t { ARRAY, BITMAP, RUN };
+    static constexpr size_t ARRAY_MAX = 4096;    // Beyond this an array is larger than a bitmap
+    static constexpr size_t BITMAP_WORDS = 1024; // 65536 bits
+
+    struct Run {
+        std::uint16_t start;
+        std::uint16_t last; // Inclusive
+    };
+
+    struct Container {
+        std::uint16_t key = 0; // High 16 bits shared by every value in the container
+        Kind kind = ARRAY;
+        std::uint32_t cardinality = 0;
+        std::vector<std::uint16_t> values; // ARRAY: sorted low parts
+        std::vector<std::uint64_t> words;  // BITMAP: BITMAP_WORDS words
+        std::vector<Run> runs;             // RUN: sorted, disjoint runs
+    };
+
+    std::vector<Container> containers; // Sorted by key
+
+    // Flipping the sign bit makes unsigned order match signed roll number order
+    static std::uint32_t toKey(int rollNo) { return static_cast<std::uint32_t>(rollNo) ^ 0x80000000u; }
+    static int fromKey(std::uint32_t key) { return static_cast<int>(key ^ 0x80000000u); }
+
+    static bool contains(const Container& c, std::uint16_t low) {
+        if (c.kind == BITMAP) return (c.words[low / 64] >> (low % 64)) & 1;
+        if (c.kind == ARRAY) return std::binary_search(c.values.begin(), c.values.end(), low);
+        auto it = std::upper_bound(c.runs.begin(), c.runs.end(), low, [](std::uint16_t v, const Run& r) { return v < r.start; });
+        return it != c.runs.begin() && low <= (it - 1)->last;
+    }
+
+    /**
+     * @brief Calls fn(low) for every value of a container in ascending order.
+     */
+    template <typename Fn>
+    static void forEachLow(const Container& c, Fn fn) {
+        if (c.kind == ARRAY) {
+            for (std::uint16_t low : c.values) fn(low);
+        } else if (c.kind == BITMAP) {
+            for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                for (std::uint64_t word = c.words[w]; word; word &= word - 1) {
+                    fn(static_cast<std::uint16_t>(w * 64 + ctz64(word)));
+                }
+            }
+        } else {
+            for (const Run& r : c.runs) {
+                for (unsigned low = r.start; low <= r.last; ++low) fn(static_cast<std::uint16_t>(low));
+            }
+        }
+    }
+
+    /**
+     * @brief Writes the container's bits into a BITMAP_WORDS buffer.
+     */
+    static void toWords(const Container& c, std::uint64_t* out) {
+        if (c.kind == BITMAP) {
+            std::memcpy(out, c.words.data(), BITMAP_WORDS * sizeof(std::uint64_t));
+            return;
+        }
+        std::memset(out, 0, BITMAP_WORDS * sizeof(std::uint64_t));
+        forEachLow(c, [out](std::uint16_t low) { out[low / 64] |= std::uint64_t(1) << (low % 64); });
+    }
+
+    /**
+     * @brief Picks ARRAY or BITMAP for a container from its bits and cardinality.
+     */
+    static void fromWords(Container& c, const std::uint64_t* bits, std::uint32_t cardinality) {
+        c.cardinality = cardinality;
+        c.runs.clear();
+        if (cardinality <= ARRAY_MAX) {
+            c.kind = ARRAY;
+            c.words.clear();
+            c.words.shrink_to_fit();
+            c.values.clear();
+            c.values.reserve(cardinality);
+            for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+                for (std::uint64_t word = bits[w]; word; word &= word - 1) {
+                    c.values.push_back(static_cast<std::uint16_t>(w * 64 + ctz64(word)));
+                }
+            }
+        } else {
+            c.kind = BITMAP;
+            c.values.clear();
+            c.values.shrink_to_fit();
+            c.words.assign(bits, bits + BITMAP_WORDS);
+        }
+    }
+
+    /**
+     * @brief Turns a RUN container back into an ARRAY or BITMAP so it can be modified.
+     */
+    static void makeMutable(Container& c) {
+        if (c.kind != RUN) return;
+        std::vector<std::uint64_t> bits(BITMAP_WORDS);
+        toWords(c, bits.data());
+        fromWords(c, bits.data(), c.cardinality);
+        c.runs.shrink_to_fit();
+    }
+
+    enum Op { AND, OR, ANDNOT };
+
+    /**
+     * @brief Combines two containers with the same key.
+     */
+    static Container combine(const Container& a, const Container& b, Op op) {
+        Container result;
+        result.key = a.key;
+        // Sparse side drives: probe each array value in the other container
+        if (op != OR && a.kind == ARRAY) {
+            for (std::uint16_t low : a.values) {
+                if (contains(b, low) == (op == AND)) result.values.push_back(low);
+            }
+            result.cardinality = static_cast<std::uint32_t>(result.values.size());
+            return result;
+        }
+        if (op == AND && b.kind == ARRAY) {
+            return combine(b, a, AND);
+        }
+        if (op == OR && a.kind == ARRAY && b.kind == ARRAY && a.values.size() + b.values.size() <= ARRAY_MAX) {
+            std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), std::back_inserter(result.values));
+            result.cardinality = static_cast<std::uint32_t>(result.values.size());
+            return result;
+        }
+        // Dense case: word-wise over the full 65536-bit range
+        std::vector<std::uint64_t> left(BITMAP_WORDS), right(BITMAP_WORDS);
+        toWords(a, left.data());
+        toWords(b, right.data());
+        std::uint32_t cardinality = 0;
+        for (size_t w = 0; w < BITMAP_WORDS; ++w) {
+            if (op == AND) left[w] &= right[w];
+            else if (op == OR) left[w] |= right[w];
+            else left[w] &= ~right[w];
+            cardinality += popcount64(left[w]);
+        }
+        fromWords(result, left.data(), cardinality);
+        return result;
+    }
+
+    /**
+     * @brief Merges the container lists of two bitmaps by key.
+     */
+    static RollBitmap combine(const RollBitmap& a, const RollBitmap& b, Op op) {
+        RollBitmap result;
+        size_t i = 0, j = 0;
+        while (i < a.containers.size() || j < b.containers.size()) {
+            const bool takeA = j == b.containers.size() || (i < a.containers.size() && a.containers[i].key < b.containers[j].key);
+            const bool takeB = i == a.containers.size() || (j < b.containers.size() && b.containers[j].key < a.containers[i].key);
+            if (takeA) {
+                if (op != AND) result.containers.push_back(a.containers[i]); // Only in a
+                ++i;
+            } else if (takeB) {
+                if (op == OR) result.containers.push_back(b.containers[j]); // Only in b
+                ++j;
+            } else {
+                Container c = combine(a.containers[i], b.containers[j], op);
+                if (c.cardinality > 0) result.containers.push_back(std::move(c));
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+
+    Container* findContainer(std::uint16_t key) {
+        auto it = std::lower_bound(containers.begin(), containers.end(), key, [](const Container& c, std::uint16_t k) { return c.key < k; });
+        return it != containers.end() && it->key == key ? &*it : nullptr;
+    }
+
+public:
+    /**
+     * @brief Adds a roll number.
+     * @return True if it was added, false if it was already present.
+     */
+    bool add(int rollNo) {
+        const std::uint32_t key = toKey(rollNo);
+        const std::uint16_t high = static_cast<std::uint16_t>(key >> 16);
+        const std::uint16_t low = static_cast<std::uint16_t>(key & 0xFFFF);
+
+        // Roll numbers usually arrive in ascending order, so try the last container first
+        Container* c = !containers.empty() && containers.back().key == high ? &containers.back() : findContainer(high);
+        if (!c) {
+            auto it = std::lower_bound(containers.begin(), containers.end(), high, [](const Container& x, std::uint16_t k) { return x.key < k; });
+            c = &*containers.insert(it, Container());
+            c->key = high;
+        }
+        makeMutable(*c);
+
+        if (c->kind == BITMAP) {
+            std::uint64_t& word = c->words[low / 64];
+            const std::uint64_t mask = std::uint64_t(1) << (low % 64);
+            if (word & mask) return false;
+            word |= mask;
+        } else {
+            if (c->values.empty() || c->values.back() < low) {
+                c->values.push_back(low); // Common case: appending in roll order
+            } else {
+                auto it = std::lower_bound(c->values.begin(), c->values.end(), low);
+                if (*it == low) return false;
+                c->values.insert(it, low);
+            }
+            if (c->values.size() > ARRAY_MAX) {
+                std::vector<std::uint64_t> bits(BITMAP_WORDS);
+                toWords(*c, bits.data());
+                fromWords(*c, bits.data(), c->cardinality + 1);
+                return true;
+            }
+        }
+        ++c->cardinality;
+        return true;
+    }
+
+    /**
+     * @brief Removes a roll number.
+     * @return True if it was removed, false if it was not present.
+     */
+    bool remove(int rollNo) {
+        const std::uint32_t key = toKey(rollNo);
+        Container* c = findContainer(static_cast<std::uint16_t>(key >> 16));
+        const std::uint16_t low = static_cast<std::uint16_t>(key & 0xFFFF);
+        if (!c || !contains(*c, low)) return false;
+        makeMutable(*c);
+
+        if (c->kind == BITMAP) {
+            c->words[low / 64] &= ~(std::uint64_t(1) << (low % 64));
+            if (--c->cardinality <= ARRAY_MAX) {
+                std::vector<std::uint64_t> bits(c->words);
+                fromWords(*c, bits.data(), c->cardinality);
+            }
+        } else {
+            c->values.erase(std::lower_bound(c->values.begin(), c->values.end(), low));
+            --c->cardinality;
+        }
+        if (c->cardinality == 0) {
+            containers.erase(containers.begin() + (c - containers.data()));
+        }
+        return true;
+    }
+
+    bool contains(int rollNo) const {
+        const std::uint32_t key = toKey(rollNo);
+        auto it = std::lower_bound(containers.begin(), containers.end(), static_cast<std::uint16_t>(key >> 16),
+                                   [](const Container& c, std::uint16_t k) { return c.key < k; });
+        return it != containers.end() && it->key == (key >> 16) && contains(*it, static_cast<std::uint16_t>(key & 0xFFFF));
+    }
+
+    /**
+     * @brief Number of roll numbers in the set.
+     */
+    size_t cardinality() const {
+        size_t count = 0;
+        for (const Container& c : containers) count += c.cardinality;
+        return count;
+    }
+
+    bool empty() const {
+        return containers.empty();
+    }
+
+    // Set algebra; each returns a new bitmap
+    RollBitmap intersect(const RollBitmap& other) const { return combine(*this, other, AND); }
+    RollBitmap unite(const RollBitmap& other) const { return combine(*this, other, OR); }
+    RollBitmap subtract(const RollBitmap& other) const { return combine(*this, other, ANDNOT); }
+
+    /**
+     * @brief Calls fn(rollNo) for every roll number in ascending order.
+     */
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (const Container& c : containers) {
+            const std::uint32_t high = static_cast<std::uint32_t>(c.key) << 16;
+            forEachLow(c, [&](std::uint16_t low) { fn(fromKey(high | low)); });
+        }
+    }
+
+    /**
+     * @brief Bytes held by the container list and the containers' storage.
+     */
+    size_t bytes() const {
+        size_t total = containers.capacity() * sizeof(Container);
+        for (const Container& c : containers) {
+            total += c.values.capacity() * sizeof(std::uint16_t) + c.words.capacity() * sizeof(std::uint64_t) + c.runs.capacity() * sizeof(Run);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Converts to the smallest container forms and drops spare capacity.
+     */
+    void compact() {
+        runOptimize();
+        for (Container& c : containers) c.values.shrink_to_fit();
+        containers.shrink_to_fit();
+    }
+
+    /**
+     * @brief Converts containers to runs wherever that is the smallest form.
+     * Meant for sets that are built once and then mostly read, e.g. after a load.
+     */
+    void runOptimize() {
+        for (Container& c : containers) {
+            if (c.kind == RUN) continue;
+            std::vector<Run> runs;
+            forEachLow(c, [&runs](std::uint16_t low) {
+                if (!runs.empty() && runs.back().last + 1 == low) runs.back().last = low;
+                else runs.push_back(Run{low, low});
+            });
+            const size_t currentBytes = c.kind == ARRAY ? c.values.size() * sizeof(std::uint16_t) : BITMAP_WORDS * sizeof(std::uint64_t);
+            if (runs.size() * sizeof(Run) < currentBytes) {
+                c.kind = RUN;
+                c.runs = std::move(runs);
+                c.runs.shrink_to_fit();
+                std::vector<std::uint16_t>().swap(c.values);
+                std::vector<std::uint64_t>().swap(c.words);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Column-oriented copy of every mark, for analytic scans.
+ *
+ * Two parallel columns, rolls[] and days[], sorted by roll number and then by
+ * day, so a scan is a straight pass over 6 bytes per mark with no pointer
+ * chasing and loops the compiler can vectorize. The columns are optional:
+ * they are built from the StudentTable on demand (or at load with
+ * --columnar) and then kept in sync. Marks and unmarks made after the build
+ * are queued as small deltas and merged into the columns in one linear pass
+ * before the next scan, so a single mark never shifts the whole table.
+ */
+class AttendanceColumns {
+private:
+    typedef std::pair<std::int32_t, DayNum> Mark;
+    static constexpr size_t MERGE_THRESHOLD = 65536; // Pending deltas merged eagerly beyond this
+
+    std::vector<std::int32_t> rolls;
+    std::vector<DayNum> days;
+    std::vector<Mark> added;   // Marks made since the last merge
+    std::vector<Mark> removed; // Marks removed since the last merge
+
+    /**
+     * @brief Cancels a pending delta of the opposite kind, if there is one.
+     */
+    static bool cancel(std::vector<Mark>& pending, const Mark& mark) {
+        for (size_t i = pending.size(); i-- > 0;) {
+            if (pending[i] == mark) {
+                pending.erase(pending.begin() + i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    /**
+     * @brief Rebuilds both columns from the student table.
+     */
+    void build(const StudentTable& table) {
+        rolls.clear();
+        days.clear();
+        added.clear();
+        removed.clear();
+        size_t total = 0;
+        for (size_t slot = 0; slot < table.size(); ++slot) total += table.daysAt(slot).size();
+        rolls.reserve(total);
+        days.reserve(total);
+        for (std::uint32_t slot : table.rollOrder()) {
+            const std::int32_t rollNo = table.rollAt(slot);
+            table.daysAt(slot).forEach([&](DayNum day) {
+                rolls.push_back(rollNo);
+                days.push_back(day);
+            });
+        }
+    }
+
+    /**
+     * @brief Records a new mark (the caller guarantees it was not present).
+     */
+    void add(int rollNo, DayNum day) {
+        if (removed.empty() || !cancel(removed, Mark(rollNo, day))) added.emplace_back(rollNo, day);
+        if (added.size() + removed.size() > MERGE_THRESHOLD) merge();
+    }
+
+    /**
+     * @brief Records a removed mark (the caller guarantees it was present).
+     */
+    void remove(int rollNo, DayNum day) {
+        if (added.empty() || !cancel(added, Mark(rollNo, day))) removed.emplace_back(rollNo, day);
+        if (added.size() + removed.size() > MERGE_THRESHOLD) merge();
+    }
+
+    /**
+     * @brief Applies the pending deltas to the columns in one sorted merge.
+     */
+    void merge() {
+        if (added.empty() && removed.empty()) return;
+        std::sort(added.begin(), added.end());
+        std::sort(removed.begin(), removed.end());
+
+        std::vector<std::int32_t> newRolls;
+        std::vector<DayNum> newDays;
+        newRolls.reserve(rolls.size() + added.size() - removed.size());
+        newDays.reserve(rolls.size() + added.size() - removed.size());
+        size_t a = 0, r = 0;
+        for (size_t i = 0; i < rolls.size(); ++i) {
+            const Mark current(rolls[i], days[i]);
+            for (; a < added.size() && added[a] < current; ++a) {
+                newRolls.push_back(added[a].first);
+                newDays.push_back(added[a].second);
+            }
+            if (r < removed.size() && removed[r] == current) {
+                ++r; // Unmarked since the last merge
+                continue;
+            }
+            newRolls.push_back(current.first);
+            newDays.push_back(current.second);
+        }
+        for (; a < added.size(); ++a) {
+            newRolls.push_back(added[a].first);
+            newDays.push_back(added[a].second);
+        }
+        rolls.swap(newRolls);
+        days.swap(newDays);
+        added.clear();
+        removed.clear();
+    }
+
+    /**
+     * @brief Bytes held by the columns and the pending deltas.
+     */
+    size_t bytes() const {
+        return rolls.capacity() * sizeof(std::int32_t) + days.capacity() * sizeof(DayNum) + (added.capacity() + removed.capacity()) * sizeof(Mark);
+    }
+
+    /**
+     * @brief Merges pending deltas and drops spare capacity.
+     */
+    void compact() {
+        merge();
+        rolls.shrink_to_fit();
+        days.shrink_to_fit();
+        std::vector<Mark>().swap(added);
+        std::vector<Mark>().swap(removed);
+    }
+
+    /**
+     * @brief Number of marks in the merged columns.
+     */
+    size_t rows() const {
+        return rolls.size();
+    }
+
+    /**
+     * @brief Calls fn(rollNo, count) for every student with their number of marks in [from, to].
+     * Students with no marks at all are not in the columns. Call merge() first.
+     */
+    template <typename Fn>
+    void countPerStudent(DayNum from, DayNum to, Fn fn) const {
+        const unsigned span = static_cast<unsigned>(to - from);
+        const size_t n = rolls.size();
+        for (size_t i = 0; i < n;) {
+            const std::int32_t rollNo = rolls[i];
+            size_t end = i;
+            while (end < n && rolls[end] == rollNo) ++end;
+            size_t count = 0;
+            for (size_t j = i; j < end; ++j) {
+                count += static_cast<unsigned>(days[j] - from) <= span; // Branch-free range test
+            }
+            fn(rollNo, count);
+            i = end;
+        }
+    }
+};
+
+/**
+ * @brief Read-only view of a whole file, memory-mapped where the platform supports it.
+ */
+class MappedFile {
+private:
+    const char* fileData = nullptr;
+    size_t fileSize = 0;
+#ifdef _WIN32
+    std::vector<char> buffer; // No mmap: the file is read into memory instead
+#endif
+
+public:
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                fileData = static_cast<const char*>(addr);
+                fileSize = st.st_size;
+            }
+        }
+        close(fd); // The mapping stays valid after the descriptor is closed
+#else
+        std::ifstream inFile(path, std::ios::binary);
+        if (!inFile.is_open()) return;
+        buffer.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+        fileData = buffer.data();
+        fileSize = buffer.size();
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (fileData) munmap(const_cast<char*>(fileData), fileSize);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return fileData != nullptr; }
+    const char* data() const { return fileData; }
+    size_t size() const { return fileSize; }
+};
+
+// ---------------------------------------------------------------------------
+// Structural scanning of attendance_data.json
+//
+// The loader works simdjson-style in two stages. Stage 1 classifies the input
+// 64 bytes at a time into bitmasks (quotes, backslashes, structural characters,
+// whitespace) with the widest kernel the CPU supports, then derives which bytes
+// are inside strings with a prefix XOR over the quote bits. Stage 2 (the
+// AttendanceJsonParser below) only ever looks at the structural positions that
+// stage 1 hands it, never at the bytes in between.
+// ---------------------------------------------------------------------------
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ATTENDANCE_X86_SIMD 1
+#include <immintrin.h> // For the SSE2/AVX2 classification kernels
+#endif
+
+// Character classes of one 64-byte block, one bit per byte
+struct BlockMasks {
+    std::uint64_t quote = 0;
+    std::uint64_t backslash = 0;
+    std::uint64_t structural = 0; // { } [ ] : ,
+    std::uint64_t whitespace = 0;
+};
+
+typedef void (*ClassifyBlockFn)(const char* block, BlockMasks& masks);
+
+void classifyBlockScalar(const char* block, BlockMasks& masks) {
+    masks = BlockMasks();
+    for (int i = 0; i < 64; ++i) {
+        const std::uint64_t bit = std::uint64_t(1) << i;
+        switch (block[i]) {
+            case '"': masks.quote |= bit; break;
+            case '\\': masks.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': masks.structural |= bit; break;
+            case ' ': case '\t': case '\n': case '\r': masks.whitespace |= bit; break;
+            default: break;
+        }
+    }
+}
+
+#ifdef ATTENDANCE_X86_SIMD
+__attribute__((target("sse2"))) void classifyBlockSse2(const char* block, BlockMasks& masks) {
+    // Intrinsics are written out rather than wrapped in helpers: lambdas would not inherit the target attribute
+    masks = BlockMasks();
+    for (int i = 0; i < 64; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        const __m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+        const __m128i backslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+        const __m128i braces = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('{')), _mm_cmpeq_epi8(v, _mm_set1_epi8('}')));
+        const __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('[')), _mm_cmpeq_epi8(v, _mm_set1_epi8(']')));
+        const __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+        const __m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+        const __m128i newlines = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+        masks.quote |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(quote))) << i;
+        masks.backslash |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(backslash))) << i;
+        masks.structural |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(braces, brackets), separators)))) << i;
+        masks.whitespace |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_or_si128(spaces, newlines)))) << i;
+    }
+}
+
+__attribute__((target("avx2"))) void classifyBlockAvx2(const char* block, BlockMasks& masks) {
+    // Intrinsics are written out rather than wrapped in helpers: lambdas would not inherit the target attribute
+    masks = BlockMasks();
+    for (int i = 0; i < 64; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        const __m256i quote = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'));
+        const __m256i backslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+        const __m256i braces = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('}')));
+        const __m256i brackets = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('[')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(']')));
+        const __m256i separators = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')));
+        const __m256i spaces = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+        const __m256i newlines = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+        masks.quote |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(quote))) << i;
+        masks.backslash |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(backslash))) << i;
+        masks.structural |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(braces, brackets), separators)))) << i;
+        masks.whitespace |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(spaces, newlines)))) << i;
+    }
+}
+#endif
+
+/**
+ * @brief Picks the classification kernel for this CPU, once per process.
+ * ATTENDANCE_SIMD=scalar|sse2|avx2 in the environment forces a kernel (if supported).
+ */
+ClassifyBlockFn selectClassifyBlock() {
+    const char* forced = std::getenv("ATTENDANCE_SIMD");
+    const std::string want = forced ? forced : "";
+#ifdef ATTENDANCE_X86_SIMD
+    __builtin_cpu_init();
+    if ((want.empty() || want == "avx2") && __builtin_cpu_supports("avx2")) {
+        return classifyBlockAvx2;
+    }
+    if ((want.empty() || want == "avx2" || want == "sse2") && __builtin_cpu_supports("sse2")) {
+        return classifyBlockSse2;
+    }
+#endif
+    return classifyBlockScalar;
+}
+
+/**
+ * @brief Marks quotes that are escaped by an odd run of backslashes (simdjson's algorithm).
+ * @param backslash Backslash bits of the block.
+ * @param prevEscaped Carry between blocks: 1 if the first byte of the next block is escaped.
+ * @return Bits of bytes that are escaped.
+ */
+inline std::uint64_t findEscaped(std::uint64_t backslash, std::uint64_t& prevEscaped) {
+    if (!backslash && !prevEscaped) return 0; // Common case: dates contain no escapes
+    const std::uint64_t evenBits = 0x5555555555555555ULL;
+    backslash &= ~prevEscaped;
+    const std::uint64_t followsEscape = (backslash << 1) | prevEscaped;
+    const std::uint64_t oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+    const std::uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+    prevEscaped = sequencesStartingOnEvenBits < backslash; // Carry out of the addition
+    const std::uint64_t invertMask = sequencesStartingOnEvenBits << 1;
+    return (evenBits ^ invertMask) & followsEscape;
+}
+
+/**
+ * @brief Bitwise prefix XOR: bit i of the result is the XOR of bits 0..i.
+ * Over the quote bits this is 1 from an opening quote up to (not including) its closing quote.
+ */
+inline std::uint64_t prefixXor(std::uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+/**
+ * @brief Stage 2: turns structural positions into (roll number, days) pairs.
+ *
+ * Accepts exactly the format saveData() writes, with optional whitespace and
+ * unquoted roll numbers: {"101":["2025-07-01","2025-07-02"], "102":[]}
+ * Positions are fed one at a time in file order, so the input can be indexed
+ * block by block without materialising an index of the whole file.
+ */
+class AttendanceJsonParser {
+public:
+    enum State { START, KEY, KEY_STRING, COLON, ARRAY, DATE, DATE_STRING, AFTER_DATE, AFTER_ARRAY, END, FAILED };
+
+private:
+    const char* input;
+    size_t length;
+    State state = START;
+    bool first = true;        // No element seen yet in the current object/array
+    size_t stringStart = 0;   // Position of the opening quote of the current string
+    int rollNo = 0;
+    std::vector<DayNum> days; // Current student's days, reused across students
+
+    /**
+     * @brief Parses an optionally negative decimal roll number from [pos, pos+count).
+     */
+    bool parseRoll(size_t pos, size_t count) {
+        const bool negative = count > 0 && input[pos] == '-';
+        if (negative) { ++pos; --count; }
+        if (count == 0 || count > 10) return false;
+        long long value = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const char c = input[pos + i];
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + (c - '0');
+        }
+        if (value > 2147483647LL + (negative ? 1 : 0)) return false; // INT_MIN is a valid roll number
+        rollNo = static_cast<int>(negative ? -value : value);
+        return true;
+    }
+
+    bool fail(size_t pos, const char* what) {
+        state = FAILED;
+        errorPos = pos;
+        error = what;
+        return false;
+    }
+
+public:
+    size_t errorPos = 0;
+    std::string error;
+    size_t skippedDates = 0;  // Date strings that are not valid dates and were left out
+    std::string firstSkipped; // The first of them, for error messages
+
+    AttendanceJsonParser(const char* data, size_t size) : input(data), length(size) {}
+
+    /**
+     * @brief Consumes the structural character at pos.
+     * @param onStudent Called with (rollNo, sorted days) after each student's array.
+     * @return False once the input is known to be invalid.
+     */
+    template <typename OnStudent>
+    bool feed(size_t pos, OnStudent& onStudent) {
+        const char c = input[pos];
+        switch (state) {
+            case START:
+                if (c != '{') return fail(pos, "expected '{'");
+                state = KEY;
+                first = true;
+                return true;
+            case KEY:
+                if (c == '}' && first) { state = END; return true; }
+                if (c == '"') { stringStart = pos; state = KEY_STRING; return true; }
+                if (c == '-' || (c >= '0' && c <= '9')) {
+                    // Unquoted roll number: runs until whitespace or the ':'
+                    size_t stop = pos;
+                    while (stop < length && (input[stop] == '-' || (input[stop] >= '0' && input[stop] <= '9'))) ++stop;
+                    if (!parseRoll(pos, stop - pos)) return fail(pos, "invalid roll number");
+                    state = COLON;
+                    return true;
+                }
+                return fail(pos, "expected roll number");
+            case KEY_STRING:
+                if (c != '"' || !parseRoll(stringStart + 1, pos - stringStart - 1)) return fail(stringStart, "invalid roll number");
+                state = COLON;
+                return true;
+            case COLON:
+                if (c != ':') return fail(pos, "expected ':'");
+                state = ARRAY;
+                return true;
+            case ARRAY:
+                if (c != '[') return fail(pos, "expected '['");
+                days.clear();
+                state = DATE;
+                first = true;
+                return true;
+            case DATE:
+                if (c == '"') { stringStart = pos; state = DATE_STRING; return true; }
+                if (c == ']' && first) break;
+                return fail(pos, "expected date string");
+            case DATE_STRING: {
+                // The next structural after an opening quote is always its closing quote
+                DayNum day;
+                if (parseDate(input + stringStart + 1, pos - stringStart - 1, day)) {
+                    days.push_back(day);
+                } else {
+                    const std::string text(input + stringStart + 1, pos - stringStart - 1);
+                    std::cerr << "Warning: Skipping invalid date \"" << text << "\" for Roll No " << rollNo << std::endl;
+                    if (skippedDates++ == 0) {
+                        firstSkipped = "\"" + text + "\" for Roll No " + std::to_string(rollNo);
+                    }
+                }
+                state = AFTER_DATE;
+                return true;
+            }
+            case AFTER_DATE:
+                if (c == ',') { state = DATE; first = false; return true; }
+                if (c == ']') break;
+                return fail(pos, "expected ',' or ']'");
+            case AFTER_ARRAY:
+                if (c == ',') { state = KEY; first = false; return true; }
+                if (c == '}') { state = END; return true; }
+                return fail(pos, "expected ',' or '}'");
+            case END:
+                return fail(pos, "unexpected content after '}'");
+            case FAILED:
+                return false;
+        }
+
+        // Closing ']' of a student's array
+        if (!std::is_sorted(days.begin(), days.end())) {
+            std::sort(days.begin(), days.end()); // Ensure loaded dates are sorted
+        }
+        onStudent(rollNo, days);
+        state = AFTER_ARRAY;
+        return true;
+    }
+
+    /**
+     * @brief Checks that the input ended in a complete object.
+     */
+    bool finish() {
+        if (state == FAILED) return false;
+        if (state != END) return fail(length, "unexpected end of file");
+        return true;
+    }
+};
+
+/**
+ * @brief Runs both stages over a JSON buffer.
+ * @param data The JSON text.
+ * @param size Its length in bytes.
+ * @param parser Stage 2 parser over the same buffer.
+ * @param onStudent Called with (rollNo, sorted days) for each student.
+ * @return True if the whole buffer parsed.
+ */
+template <typename OnStudent>
+bool scanAttendanceJson(const char* data, size_t size, AttendanceJsonParser& parser, OnStudent onStudent) {
+    static const ClassifyBlockFn classifyBlock = selectClassifyBlock();
+
+    std::uint64_t prevEscaped = 0;   // Carry of backslash runs across blocks
+    std::uint64_t prevInString = 0;  // All ones if the previous block ended inside a string
+    std::uint64_t prevScalar = 0;    // 1 if the previous block ended in the middle of a bare token
+    char tail[64];
+
+    for (size_t offset = 0; offset < size; offset += 64) {
+        const char* block = data + offset;
+        if (size - offset < 64) {
+            // Pad the last partial block with spaces
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, block, size - offset);
+            block = tail;
+        }
+
+        BlockMasks masks;
+        classifyBlock(block, masks);
+
+        const std::uint64_t quotes = masks.quote & ~findEscaped(masks.backslash, prevEscaped);
+        const std::uint64_t inString = prefixXor(quotes) ^ prevInString; // Opening quote and body, not the closing quote
+        prevInString = static_cast<std::uint64_t>(static_cast<std::int64_t>(inString) >> 63);
+
+        // Bytes outside strings that are neither structural nor whitespace start a bare token
+        // (an unquoted roll number, or garbage that stage 2 will reject)
+        const std::uint64_t scalar = ~(masks.structural | masks.whitespace | quotes | inString);
+        const std::uint64_t scalarStart = scalar & ~((scalar << 1) | prevScalar);
+        prevScalar = scalar >> 63;
+
+        std::uint64_t structurals = ((masks.structural | scalarStart) & ~inString) | quotes;
+        while (structurals) {
+            if (!parser.feed(offset + ctz64(structurals), onStudent)) return false;
+            structurals &= structurals - 1;
+        }
+    }
+    return parser.finish();
+}
+
+/**
+ * @brief Forces a file's contents to stable storage.
+ * @param file An open stream; it is flushed first.
+ * @return True if the data is durable.
+ */
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#ifndef _WIN32
+    return fsync(fileno(file)) == 0;
+#else
+    return _commit(_fileno(file)) == 0;
+#endif
+}
+
+/**
+ * @brief Makes a completely written temporary file durable and renames it over path.
+ * Readers and crash recovery therefore see either the old or the new file, never a
+ * partially written one.
+ * @param tmpPath The temporary file (already closed).
+ * @param path The destination.
+ * @return True if the replacement is durable.
+ */
+bool commitFile(const std::string& tmpPath, const std::string& path) {
+    std::FILE* tmp = std::fopen(tmpPath.c_str(), "ab");
+    bool ok = tmp && syncFile(tmp);
+    if (tmp) std::fclose(tmp);
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmpPath, path, ec);
+    if (!ok || ec) {
+        std::cerr << "Error: Could not replace " << path << " with " << tmpPath << std::endl;
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+#ifndef _WIN32
+    // Persist the rename itself
+    std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    int dirFd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+#endif
+    return true;
+}
+
+/**
+ * @brief Takes the exclusive data lock for the lifetime of the process.
+ * Waits up to LOCK_TIMEOUT_MS, so short CLI calls queue behind each other
+ * but do not hang forever behind a running server.
+ * @return True if the lock is held.
+ */
+bool lockDataFiles() {
+#ifndef _WIN32
+    static int lockFd = -1;
+    if (lockFd >= 0) return true;
+    lockFd = open(LOCK_FILENAME.c_str(), O_RDWR | O_CREAT, 0644);
+    if (lockFd < 0) return false;
+    for (int waited = 0; flock(lockFd, LOCK_EX | LOCK_NB) != 0; waited += 10) {
+        if (errno != EWOULDBLOCK || waited >= LOCK_TIMEOUT_MS) {
+            close(lockFd);
+            lockFd = -1;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+#else
+    static int lockFd = -1;
+    if (lockFd >= 0) return true;
+    lockFd = _open(LOCK_FILENAME.c_str(), _O_RDWR | _O_CREAT, _S_IREAD | _S_IWRITE);
+    if (lockFd < 0) return false;
+    // Locks the first byte; _LK_NBLCK fails at once, where _LK_LOCK would retry on its own schedule
+    for (int waited = 0; _locking(lockFd, _LK_NBLCK, 1) != 0; waited += 10) {
+        if (errno != EACCES || waited >= LOCK_TIMEOUT_MS) {
+            _close(lockFd);
+            lockFd = -1;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+#endif
+    return true;
+}
+
+/**
+ * @brief Set of working days, used as the denominator of attendance percentages.
+ *
+ * One bit per possible DayNum (8 KB in total) plus a running count of working
+ * days before each 64-day word, so "working days in [from, to]" is two lookups
+ * and two popcounts and "is this a working day" is a single bit test.
+ */
+class WorkCalendar {
+private:
+    static constexpr size_t WORDS = 65536 / 64;
+
+    std::vector<std::uint64_t> working = std::vector<std::uint64_t>(WORDS, 0);
+    std::vector<std::uint32_t> before = std::vector<std::uint32_t>(WORDS + 1, 0); // Working days in words [0, w)
+    bool fromFile = false;
+
+    static bool isWeekday(long day) {
+        const long weekday = (day + 4) % 7; // 1970-01-01 was a Thursday; 0 = Sunday
+        return weekday >= 1 && weekday <= 5;
+    }
+
+    void set(long day, bool on) {
+        const std::uint64_t mask = std::uint64_t(1) << (day % 64);
+        if (on) working[day / 64] |= mask;
+        else working[day / 64] &= ~mask;
+    }
+
+    void setWeekdays(long first, long last) {
+        for (long day = first; day <= last; ++day) {
+            if (isWeekday(day)) set(day, true);
+        }
+    }
+
+    void recount() {
+        for (size_t w = 0; w < WORDS; ++w) before[w + 1] = before[w] + popcount64(working[w]);
+    }
+
+    /**
+     * @brief Working days in [0, day).
+     */
+    size_t countBefore(long day) const {
+        if (day >= 65536) return before[WORDS];
+        const std::uint64_t below = (std::uint64_t(1) << (day % 64)) - 1;
+        return before[day / 64] + popcount64(working[day / 64] & below);
+    }
+
+public:
+    /**
+     * @brief Reads CALENDAR_FILENAME-style text from a file.
+     * Malformed lines are reported and skipped. When the file does not exist,
+     * every weekday is a working day.
+     * @return True if the file was read.
+     */
+    bool load(const std::string& path) {
+        std::fill(working.begin(), working.end(), 0);
+        std::ifstream inFile(path);
+        fromFile = inFile.is_open();
+        if (!fromFile) {
+            setWeekdays(0, 0xFFFF);
+            recount();
+            return false;
+        }
+
+        // Terms first, then the exceptions, whatever order the lines come in
+        std::vector<std::pair<DayNum, bool>> exceptions;
+        bool anyTerm = false;
+        std::string line;
+        while (std::getline(inFile, line)) {
+            std::stringstream ss(line);
+            std::string kind, first, second;
+            if (!(ss >> kind) || kind[0] == '#') continue;
+            ss >> first >> second;
+            DayNum start, end;
+            if (kind == "term" && parseDate(first, start) && parseDate(second, end) && start <= end) {
+                setWeekdays(start, end);
+                anyTerm = true;
+            } else if ((kind == "holiday" || kind == "workday") && second.empty() && parseDate(first, start)) {
+                exceptions.emplace_back(start, kind == "workday");
+            } else {
+                std::cerr << "Warning: Skipping malformed line in " << path << ": " << line << std::endl;
+            }
+        }
+        if (!anyTerm) setWeekdays(0, 0xFFFF); // Only exceptions given: start from every weekday
+        for (const auto& exception : exceptions) set(exception.first, exception.second);
+        recount();
+        return true;
+    }
+
+    bool isWorking(DayNum day) const {
+        return (working[day / 64] >> (day % 64)) & 1;
+    }
+
+    /**
+     * @brief Number of working days before a day, i.e. its position among working days.
+     */
+    size_t rank(DayNum day) const {
+        return countBefore(day);
+    }
+
+    /**
+     * @brief Number of working days in [from, to].
+     */
+    size_t countWorking(DayNum from, DayNum to) const {
+        if (from > to) return 0;
+        return countBefore(static_cast<long>(to) + 1) - countBefore(from);
+    }
+
+    /**
+     * @brief True if the calendar came from CALENDAR_FILENAME rather than the weekday default.
+     */
+    bool isFromFile() const {
+        return fromFile;
+    }
+};
+
+/**
+ * @brief Presence and absence runs of one student over a sequence of working days.
+ */
+struct StreakStats {
+    size_t present = 0;
+    size_t longestAbsence = 0; // Longest run of consecutive working days absent
+    size_t absenceEpisodes = 0; // Number of separate absence runs
+    size_t currentStreak = 0;   // Working days present up to and including the last one
+    size_t currentAbsence = 0;  // Working days absent up to and including the last one
+};
+
+/**
+ * @brief First position >= from whose bit is set (or clear, when inverted), or bits if none.
+ */
+inline size_t nextBit(const std::vector<std::uint64_t>& words, size_t bits, size_t from, bool inverted) {
+    const std::uint64_t flip = inverted ? ~std::uint64_t(0) : 0;
+    for (size_t w = from / 64; w * 64 < bits; ++w) {
+        std::uint64_t word = words[w] ^ flip;
+        if (w == from / 64) word &= ~std::uint64_t(0) << (from % 64);
+        if (word) return std::min(bits, w * 64 + ctz64(word));
+    }
+    return bits;
+}
+
+/**
+ * @brief Last position < end whose bit is set (or clear, when inverted), or bits if none.
+ */
+inline size_t prevBit(const std::vector<std::uint64_t>& words, size_t bits, size_t end, bool inverted) {
+    const std::uint64_t flip = inverted ? ~std::uint64_t(0) : 0;
+    for (size_t w = (end + 63) / 64; w-- > 0;) {
+        std::uint64_t word = words[w] ^ flip;
+        if (w == end / 64) word &= (std::uint64_t(1) << (end % 64)) - 1; // Only bits below end
+        if (word) return w * 64 + highBit64(word);
+    }
+    return bits;
+}
+
+/**
+ * @brief Computes streak figures from a presence bitset over `bits` working days.
+ * Runs are found a word at a time: trailing-zero counts jump straight to the
+ * next absent or present day, and the current streak is read from the top
+ * set bit of the last words, so no day is visited individually.
+ */
+inline StreakStats computeStreaks(const std::vector<std::uint64_t>& presence, size_t bits) {
+    StreakStats stats;
+    for (size_t w = 0; w < (bits + 63) / 64; ++w) stats.present += popcount64(presence[w]);
+
+    for (size_t pos = nextBit(presence, bits, 0, true); pos < bits;) {
+        const size_t end = nextBit(presence, bits, pos, false); // Absence run is [pos, end)
+        ++stats.absenceEpisodes;
+        stats.longestAbsence = std::max(stats.longestAbsence, end - pos);
+        pos = end < bits ? nextBit(presence, bits, end, true) : bits;
+    }
+
+    if (bits > 0) {
+        const size_t lastAbsent = prevBit(presence, bits, bits, true);
+        const size_t lastPresent = prevBit(presence, bits, bits, false);
+        stats.currentStreak = lastAbsent == bits ? bits : bits - 1 - lastAbsent;
+        stats.currentAbsence = lastPresent == bits ? bits : bits - 1 - lastPresent;
+    }
+    return stats;
+}
+
+/**
+ * @brief Memory resource that counts the allocations it forwards upstream.
+ */
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        allocatedBytes += bytes;
+        liveBytes += bytes;
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        liveBytes -= bytes;
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    size_t allocations = 0;
+    size_t allocatedBytes = 0;
+    size_t liveBytes = 0; // Allocated and not yet returned
+
+    explicit CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+};
+
+// Define a class to encapsulate the attendance system logic
+class AttendanceSystem {
+private:
+    // Pool that every student's day list allocates from. Declared first so it outlives
+    // the table; its memory goes back to the heap in bulk when the system is destroyed.
+    // The counting heap underneath lets memstats report what day lists really cost.
+    CountingResource dayListHeap{std::pmr::new_delete_resource()};
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> dayListPool{new std::pmr::unsynchronized_pool_resource(&dayListHeap)};
+
+    // Roll number (int) -> set of days present, in a flat hash-indexed table
+    StudentTable attendance{dayListPool.get()};
+
+    // Secondary index: day number -> compressed set of roll numbers present that day. Only
+    // days with at least one mark have an entry, so each set's cardinality is that day's
+    // reference count.
+    std::map<DayNum, RollBitmap> dayIndex;
+
+    RollBitmap allStudents; // Every registered roll number, for "absent" queries
+
+    // Optional columnar copy of all marks for analytic scans; null until first needed
+    std::unique_ptr<AttendanceColumns> columns;
+
+    // Working days from CALENDAR_FILENAME, read once by loadData()
+    WorkCalendar calendar;
+
+    size_t totalEntries = 0; // Total marks across all students, kept current for getOverallStats()
+
+    // Students present per day from dailyBase (the earliest marked day) to the latest marked day,
+    // so a time series is one contiguous read. Kept current on mark and unmark like totalEntries.
+    std::vector<std::uint32_t> dailyCounts;
+    DayNum dailyBase = 0; // Day of dailyCounts[0]
+
+    // Append handle for WAL_FILENAME; only open once openLog() has been called
+    std::FILE* walFile = nullptr;
+    std::string walPending; // Records appended since the last syncLog(), not yet durable
+    size_t walRecords = 0;  // Records in WAL_FILENAME since the last checkpoint
+    std::uintmax_t walBytes = 0; // Length of WAL_FILENAME up to its last durable record
+
+    // Why checkpoint() must not rewrite DATA_FILENAME, or empty if it may. Set when the file
+    // exists but could not be loaded, so the empty store is never saved over it.
+    std::string saveBlocked;
+
+    // The changes behind walPending, so syncLog() can undo them if they cannot be made durable.
+    // newStudent: the mark registered the student, so undoing it unregisters them again.
+    struct LoggedChange { char kind; int rollNo; DayNum date; bool newStudent; };
+    std::vector<LoggedChange> walChanges;
+
+    /**
+     * @brief Helper to escape strings for JSON output (e.g., handling quotes).
+     * @param s The string to escape.
+     * @return The escaped string.
+     */
+    std::string escape_json_string(const std::string& s) const {
+        std::string escaped_s = "";
+        for (char c : s) {
+            if (c == '"') {
+                escaped_s += "\\\"";
+            } else if (c == '\\') {
+                escaped_s += "\\\\";
+            } else if (c == '\n') {
+                escaped_s += "\\n";
+            } else if (c == '\r') {
+                escaped_s += "\\r";
+            } else if (c == '\t') {
+                escaped_s += "\\t";
+            } else {
+                escaped_s += c;
+            }
+        }
+        return escaped_s;
+    }
+
+    /**
+     * @brief Returns the counter of a day, growing dailyCounts to cover it.
+     */
+    std::uint32_t& dailyCountFor(DayNum day) {
+        if (dailyCounts.empty()) {
+            dailyBase = day;
+        } else if (day < dailyBase) {
+            dailyCounts.insert(dailyCounts.begin(), static_cast<size_t>(dailyBase - day), 0); // Earlier than any marked day
+            dailyBase = day;
+        }
+        if (static_cast<size_t>(day - dailyBase) >= dailyCounts.size()) dailyCounts.resize(static_cast<size_t>(day - dailyBase) + 1, 0);
+        return dailyCounts[day - dailyBase];
+    }
+
+    /**
+     * @brief Adds a day to a student's list if it is not there yet.
+     * @param rollNo The roll number of the student.
+     * @param date The day number to add.
+     * @return True if the day was added, false if it was already present.
+     */
+    bool insertDate(int rollNo, DayNum date) {
+        const size_t studentsBefore = attendance.size();
+        if (!attendance.insert(rollNo, date)) {
+            return false;
+        }
+        if (attendance.size() != studentsBefore) {
+            allStudents.add(rollNo); // First mark of a new student
+        }
+        dayIndex[date].add(rollNo);
+        if (columns) columns->add(rollNo, date);
+        ++dailyCountFor(date);
+        ++totalEntries;
+        return true;
+    }
+
+    /**
+     * @brief Removes a day from a student's list.
+     * The student stays registered even when no days are left.
+     * @param rollNo The roll number of the student.
+     * @param date The day number to remove.
+     * @return True if the day was removed, false if it was not marked.
+     */
+    bool removeDate(int rollNo, DayNum date) {
+        DaySet* days = attendance.find(rollNo);
+        if (!days || !days->erase(date)) {
+            return false;
+        }
+        auto day = dayIndex.find(date);
+        if (day != dayIndex.end()) {
+            day->second.remove(rollNo);
+            if (day->second.empty()) {
+                dayIndex.erase(day); // Last reference to this day
+            }
+        }
+        if (columns) columns->remove(rollNo, date);
+        --dailyCounts[date - dailyBase]; // The day was marked, so it is in range
+        --totalEntries;
+        return true;
+    }
+
+    /**
+     * @brief Rebuilds the day index and entry count from scratch after a bulk load.
+     * Students are visited in roll order, so every per-day set is built by appending,
+     * and the finished sets are converted to run containers where that is smaller.
+     */
+    void rebuildIndexes() {
+        dayIndex.clear();
+        allStudents = RollBitmap();
+        totalEntries = 0;
+        dailyCounts.clear();
+        for (std::uint32_t slot : attendance.rollOrder()) {
+            const int rollNo = attendance.rollAt(slot);
+            allStudents.add(rollNo);
+            attendance.daysAt(slot).forEach([&](DayNum day) { dayIndex[day].add(rollNo); });
+            totalEntries += attendance.daysAt(slot).size();
+        }
+        for (auto& day : dayIndex) day.second.runOptimize();
+        allStudents.runOptimize();
+        if (!dayIndex.empty()) {
+            dailyBase = dayIndex.begin()->first;
+            dailyCounts.assign(static_cast<size_t>(dayIndex.rbegin()->first - dailyBase) + 1, 0);
+        }
+        for (const auto& day : dayIndex) dailyCounts[day.first - dailyBase] = static_cast<std::uint32_t>(day.second.cardinality());
+        if (columns) columns->build(attendance);
+    }
+
+    /**
+     * @brief Formats a set of roll numbers as the JSON reply shared by the set queries.
+     */
+    std::string rollSetJson(const std::vector<DayNum>& days, const RollBitmap& rolls) const {
+        std::stringstream ss;
+        ss << "{\"status\": \"success\", \"dates\": [";
+        for (size_t i = 0; i < days.size(); ++i) {
+            if (i > 0) ss << ", ";
+            ss << "\"" << DateDictionary::text(days[i]) << "\"";
+        }
+        ss << "], \"roll_nos\": [";
+        bool first = true;
+        rolls.forEach([&](int rollNo) {
+            if (!first) ss << ", ";
+            ss << rollNo;
+            first = false;
+        });
+        ss << "], \"count\": " << rolls.cardinality() << "}";
+        return ss.str();
+    }
+
+    /**
+     * @brief The JSON error reply for a date that does not parse.
+     */
+    std::string invalidDateReply(const std::string& date) const {
+        return "{\"status\": \"error\", \"message\": \"Invalid date: " + escape_json_string(date) + ". Use YYYY-MM-DD\"}";
+    }
+
+    /**
+     * @brief Parses a list of dates for the set queries.
+     * @return An empty string on success, otherwise the JSON error reply.
+     */
+    std::string parseDates(const std::vector<std::string>& dates, std::vector<DayNum>& days) const {
+        for (const std::string& date : dates) {
+            DayNum day;
+            if (!parseDate(date, day)) {
+                return invalidDateReply(date);
+            }
+            days.push_back(day);
+        }
+        return "";
+    }
+
+    /**
+     * @brief Parses the bounds of a range query.
+     * @param openEnded When true, an empty bound means no limit on that side.
+     * @return An empty string on success, otherwise the JSON error reply.
+     */
+    std::string parseDateRange(const std::string& fromDate, const std::string& toDate, DayNum& from, DayNum& to, bool openEnded = false) const {
+        const std::string rangeError = "{\"status\": \"error\", \"message\": \"Invalid date range: " + escape_json_string(fromDate) + " to " + escape_json_string(toDate) + ". Use YYYY-MM-DD, from <= to\"}";
+        from = 0;
+        to = std::numeric_limits<DayNum>::max();
+        if (openEnded) {
+            if (!fromDate.empty() && !parseDate(fromDate, from)) return invalidDateReply(fromDate);
+            if (!toDate.empty() && !parseDate(toDate, to)) return invalidDateReply(toDate);
+        } else if (!parseDate(fromDate, from) || !parseDate(toDate, to)) {
+            return rangeError;
+        }
+        return to < from ? rangeError : "";
+    }
+
+    /**
+     * @brief Queues a record for the write-ahead log, if the log is open.
+     * The record becomes durable at the next syncLog().
+     * @param kind 'M' for a mark, 'U' for an unmark.
+     * @param rollNo The roll number of the student.
+     * @param date The affected day.
+     * @param newStudent True if this mark registered the student.
+     */
+    void logRecord(char kind, int rollNo, DayNum date, bool newStudent = false) {
+        if (!walFile) return;
+        walPending += kind + (' ' + std::to_string(rollNo)) + ' ';
+        walPending += DateDictionary::text(date);
+        walPending += '\n';
+        walChanges.push_back({kind, rollNo, date, newStudent});
+        ++walRecords;
+    }
+
+public:
+    // Constructor (optional, can be empty for simple initialization)
+    AttendanceSystem() {
+        // Data will now be loaded from file, so no dummy data here.
+    }
+
+    ~AttendanceSystem() {
+        if (walFile) {
+            syncLog();
+            std::fclose(walFile);
+        }
+    }
+
+    /**
+     * @brief Loads attendance data from the binary snapshot.
+     * The file is memory-mapped and its packed day arrays are copied straight
+     * into the map: they are already sorted and sized, so there is no parsing,
+     * sorting or vector regrowth. Version 1 snapshots (ISO date text) are still
+     * accepted and converted while loading.
+     * @return True if the snapshot was loaded successfully, false otherwise.
+     */
+    bool loadSnapshot() {
+        MappedFile file(SNAPSHOT_FILENAME);
+        if (!file.isOpen() || file.size() < sizeof(SnapshotHeader)) {
+            return false;
+        }
+
+        SnapshotHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header.version < 1 || header.version > SNAPSHOT_VERSION ||
+            (header.version == SNAPSHOT_VERSION && header.dateWidth != sizeof(DayNum))) {
+            std::cerr << "Error: " << SNAPSHOT_FILENAME << " is not a supported snapshot." << std::endl;
+            return false;
+        }
+
+        const size_t tableBytes = static_cast<size_t>(header.studentCount) * sizeof(SnapshotStudent);
+        const char* table = file.data() + sizeof(SnapshotHeader);
+        const char* dates = table + tableBytes;
+        if (header.dateWidth == 0 || file.size() - sizeof(SnapshotHeader) < tableBytes ||
+            (file.size() - sizeof(SnapshotHeader) - tableBytes) / header.dateWidth < header.dateCount) {
+            std::cerr << "Error: " << SNAPSHOT_FILENAME << " is truncated." << std::endl;
+            return false;
+        }
+
+        attendance.reserve(header.studentCount);
+        std::vector<DayNum> studentDays; // Reused buffer for one student's (unaligned) day array
+        size_t skippedDates = 0;         // Version 1 date strings that are not valid dates
+        std::string firstSkipped;
+        for (std::uint32_t i = 0; i < header.studentCount; ++i) {
+            SnapshotStudent student;
+            std::memcpy(&student, table + i * sizeof(SnapshotStudent), sizeof(student));
+            if (student.firstDate > header.dateCount || header.dateCount - student.firstDate < student.dateCount) {
+                std::cerr << "Error: Corrupt student table in " << SNAPSHOT_FILENAME << std::endl;
+                attendance.clear();
+                return false;
+            }
+
+            const char* date = dates + student.firstDate * header.dateWidth;
+            if (header.version == SNAPSHOT_VERSION) {
+                studentDays.resize(student.dateCount);
+                if (student.dateCount > 0) std::memcpy(studentDays.data(), date, student.dateCount * sizeof(DayNum));
+            } else {
+                studentDays.clear();
+                for (std::uint32_t d = 0; d < student.dateCount; ++d, date += header.dateWidth) {
+                    DayNum day;
+                    const size_t dateLength = strnlen(date, header.dateWidth);
+                    if (parseDate(date, dateLength, day)) {
+                        studentDays.push_back(day);
+                    } else if (skippedDates++ == 0) {
+                        firstSkipped = "\"" + std::string(date, dateLength) + "\" for Roll No " + std::to_string(student.rollNo);
+                    }
+                }
+            }
+            attendance.insertSorted(student.rollNo, studentDays.data(), studentDays.size());
+        }
+        if (skippedDates > 0) {
+            std::cerr << "Warning: Skipped " << skippedDates << " invalid date(s) in " << SNAPSHOT_FILENAME << ", first " << firstSkipped << std::endl;
+            saveBlocked = SNAPSHOT_FILENAME + " has " + std::to_string(skippedDates) + " invalid date(s), first " +
+                          firstSkipped + "; fix or remove them first";
+        }
+        return true;
+    }
+
+    /**
+     * @brief Saves attendance data to the binary snapshot.
+     * Written to a temporary file that atomically replaces the snapshot once durable.
+     * Must run after saveData(), or the snapshot is older than the JSON and
+     * loadData() ignores it (see snapshotIsCurrent()).
+     * @return True if the snapshot was saved successfully, false otherwise.
+     */
+    bool saveSnapshot() const {
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        header.version = SNAPSHOT_VERSION;
+        header.studentCount = static_cast<std::uint32_t>(attendance.size());
+        header.dateWidth = sizeof(DayNum);
+        const std::vector<std::uint32_t> order = attendance.rollOrder();
+        for (std::uint32_t slot : order) {
+            header.dateCount += attendance.daysAt(slot).size();
+        }
+
+        const std::string tmpPath = SNAPSHOT_FILENAME + ".tmp";
+        std::ofstream outFile(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: Could not open " << tmpPath << " for writing." << std::endl;
+            return false;
+        }
+        outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::uint64_t firstDate = 0;
+        for (std::uint32_t slot : order) {
+            const size_t count = attendance.daysAt(slot).size();
+            SnapshotStudent student{attendance.rollAt(slot), static_cast<std::uint32_t>(count), firstDate};
+            outFile.write(reinterpret_cast<const char*>(&student), sizeof(student));
+            firstDate += count;
+        }
+
+        std::vector<DayNum> studentDays;
+        for (std::uint32_t slot : order) {
+            studentDays.clear();
+            attendance.daysAt(slot).forEach([&studentDays](DayNum day) { studentDays.push_back(day); });
+            outFile.write(reinterpret_cast<const char*>(studentDays.data()), studentDays.size() * sizeof(DayNum));
+        }
+        outFile.close();
+        return !outFile.fail() && commitFile(tmpPath, SNAPSHOT_FILENAME);
+    }
+
+    /**
+     * @brief True if the snapshot exists and is not older than DATA_FILENAME.
+     * checkpoint() writes the JSON first and the snapshot second, so this holds
+     * after every checkpoint; a JSON edited by hand afterwards is newer and wins.
+     */
+    static bool snapshotIsCurrent() {
+        std::error_code snapError, jsonError;
+        auto snapTime = std::filesystem::last_write_time(SNAPSHOT_FILENAME, snapError);
+        auto jsonTime = std::filesystem::last_write_time(DATA_FILENAME, jsonError);
+        return !snapError && (jsonError || snapTime >= jsonTime);
+    }
+
+    /**
+     * @brief Loads attendance data, preferring the binary snapshot.
+     * The JSON file is used when there is no snapshot or when the JSON is newer
+     * (e.g. it was edited by hand).
+     * @return True if data was loaded successfully, false otherwise.
+     */
+    bool loadData() {
+        bool loaded = (snapshotIsCurrent() && loadSnapshot()) || loadJson();
+        rebuildIndexes();
+        calendar.load(CALENDAR_FILENAME);
+        return loaded;
+    }
+
+    /**
+     * @brief Loads attendance data from a JSON file.
+     * Expected format: {"101":["2025-07-01","2025-07-02"], "102":["2025-07-01"]}
+     * The file is mapped and indexed with vectorized structural scanning (see
+     * scanAttendanceJson); roll numbers and dates are decoded in place and go
+     * straight into the store, without building any intermediate strings.
+     * @return True if data was loaded successfully, false otherwise.
+     */
+    bool loadJson() {
+        MappedFile file(DATA_FILENAME);
+        if (!file.isOpen()) {
+            // File doesn't exist, cannot be opened or is empty, which is fine for first run.
+            return false;
+        }
+
+        AttendanceJsonParser parser(file.data(), file.size());
+        bool ok = scanAttendanceJson(file.data(), file.size(), parser, [this](int rollNo, const std::vector<DayNum>& days) {
+            attendance.insertSorted(rollNo, days.data(), days.size());
+        });
+        if (!ok) {
+            std::cerr << "Error: Invalid JSON format in " << DATA_FILENAME << " at byte " << parser.errorPos << ": " << parser.error << std::endl;
+            attendance.clear(); // Clear potentially corrupted data
+            saveBlocked = DATA_FILENAME + " could not be loaded; fix or remove it first";
+            return false;
+        }
+        if (parser.skippedDates > 0) {
+            // Saving would silently drop them
+            saveBlocked = DATA_FILENAME + " has " + std::to_string(parser.skippedDates) + " invalid date(s), first " +
+                          parser.firstSkipped + "; fix or remove them first";
+        }
+        return true;
+    }
+
+    /**
+     * @brief Saves attendance data to a JSON file.
+     * Written to a temporary file that atomically replaces the JSON once durable,
+     * so a crash mid-save leaves the previous version intact.
+     * @return True if data was saved successfully, false otherwise.
+     */
+    bool saveData() const {
+        const std::string tmpPath = DATA_FILENAME + ".tmp";
+        std::ofstream outFile(tmpPath);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: Could not open " << tmpPath << " for writing." << std::endl;
+            return false;
+        }
+
+        outFile << "{";
+        bool first_student = true;
+        for (std::uint32_t slot : attendance.rollOrder()) {
+            if (!first_student) {
+                outFile << ",";
+            }
+            outFile << "\"" << attendance.rollAt(slot) << "\":["; // Roll number as string key
+            bool first_date = true;
+            attendance.daysAt(slot).forEach([&](DayNum date) {
+                if (!first_date) {
+                    outFile << ",";
+                }
+                outFile << "\"" << DateDictionary::text(date) << "\""; // Quote date
+                first_date = false;
+            });
+            outFile << "]";
+            first_student = false;
+        }
+        outFile << "}";
+        outFile.close();
+        return !outFile.fail() && commitFile(tmpPath, DATA_FILENAME);
+    }
+
+    /**
+     * @brief Replays marks and unmarks logged in WAL_FILENAME since the last checkpoint.
+     * Call after loadData(). A torn record at the end of the log (from a crash
+     * mid-append) is ignored.
+     * @return Number of records replayed.
+     */
+    size_t replayLog() {
+        std::ifstream inFile(WAL_FILENAME);
+        if (!inFile.is_open()) {
+            return 0;
+        }
+
+        size_t replayed = 0;
+        std::streamoff validBytes = 0; // Length of the log up to the last complete record
+        std::string line;
+        while (std::getline(inFile, line)) {
+            if (inFile.eof()) break; // Last record has no '\n': it was never completely written
+            validBytes += line.size() + 1;
+
+            std::stringstream ss(line);
+            char kind = 0;
+            int rollNo = 0;
+            std::string date;
+            DayNum day;
+            if (!(ss >> kind >> rollNo >> date) || (kind != 'M' && kind != 'U') || !parseDate(date, day)) {
+                std::cerr << "Warning: Skipping malformed record in " << WAL_FILENAME << ": " << line << std::endl;
+                continue;
+            }
+            if (kind == 'M') {
+                insertDate(rollNo, day);
+            } else {
+                removeDate(rollNo, day);
+            }
+            ++replayed;
+        }
+        inFile.close();
+
+        // Cut off a torn tail so new records are not appended onto it
+        std::error_code ec;
+        if (std::filesystem::file_size(WAL_FILENAME, ec) != static_cast<std::uintmax_t>(validBytes) && !ec) {
+            std::filesystem::resize_file(WAL_FILENAME, validBytes, ec);
+        }
+        walRecords = replayed;
+        return replayed;
+    }
+
+    /**
+     * @brief Opens the write-ahead log so that subsequent marks are appended to it.
+     * @return True if the log is open for appending.
+     */
+    bool openLog() {
+        walFile = std::fopen(WAL_FILENAME.c_str(), "ab");
+        if (!walFile) {
+            std::cerr << "Error: Could not open " << WAL_FILENAME << " for appending." << std::endl;
+            return false;
+        }
+        std::setvbuf(walFile, nullptr, _IONBF, 0); // syncLog() writes whole rounds; a failed write must leave nothing buffered
+        std::error_code ec;
+        walBytes = std::filesystem::file_size(WAL_FILENAME, ec);
+        if (ec) walBytes = 0;
+        return true;
+    }
+
+    /**
+     * @brief Writes queued log records and makes them durable with a single fsync.
+     * This is the group commit: every mark queued since the previous call (e.g. all
+     * requests the server read in one poll round) shares one fsync. Callers must
+     * not acknowledge a mark before this returns true. If the write fails, the log
+     * is cut back to its last durable record and the queued changes are undone in
+     * memory, so nothing a caller reports as unsaved is still visible or persisted
+     * by a later checkpoint.
+     * @return True if every queued record is durable.
+     */
+    bool syncLog() {
+        if (!walFile || walPending.empty()) return true;
+        bool ok = std::fwrite(walPending.data(), 1, walPending.size(), walFile) == walPending.size() && syncFile(walFile);
+        if (ok) {
+            walBytes += walPending.size();
+        } else {
+            std::cerr << "Error: Could not write " << WAL_FILENAME << ": " << std::strerror(errno) << std::endl;
+            // A partly written record would have the next record glued onto it
+            std::error_code ec;
+            std::filesystem::resize_file(WAL_FILENAME, walBytes, ec);
+            std::clearerr(walFile);
+            for (auto change = walChanges.rbegin(); change != walChanges.rend(); ++change) {
+                if (change->kind == 'M') {
+                    removeDate(change->rollNo, change->date);
+                    if (change->newStudent) {
+                        // Undone newest first, so this is the last student registered
+                        attendance.removeLast();
+                        allStudents.remove(change->rollNo);
+                    }
+                } else {
+                    insertDate(change->rollNo, change->date);
+                }
+            }
+            walRecords -= walChanges.size();
+        }
+        walPending.clear();
+        walChanges.clear();
+        return ok;
+    }
+
+    /**
+     * @brief Rewrites the snapshot and DATA_FILENAME from memory and empties the write-ahead log.
+     * @return True if the checkpoint succeeded.
+     */
+    bool checkpoint() {
+        if (!syncLog()) {
+            return false; // The log cannot be written; leave the files as they are
+        }
+        if (!saveBlocked.empty()) {
+            std::cerr << "Error: Not saving: " << saveBlocked << std::endl;
+            return false; // Marks stay in the log until the data file is fixed
+        }
+        // JSON first, snapshot second: see snapshotIsCurrent()
+        if (!saveData() || !saveSnapshot()) {
+            return false; // Keep the log: it still holds marks missing from the snapshot
+        }
+        // Both files are durable, so the log can go; reopening it "wb" truncates it
+        std::FILE* truncated = std::fopen(WAL_FILENAME.c_str(), "wb");
+        if (truncated) {
+            syncFile(truncated);
+            std::fclose(truncated);
+            walBytes = 0;
+        }
+        walRecords = 0;
+        return true;
+    }
+
+    /**
+     * @brief Runs a checkpoint once the log has grown past WAL_CHECKPOINT_RECORDS.
+     * @return True unless a needed checkpoint failed.
+     */
+    bool checkpointIfNeeded() {
+        return walRecords < WAL_CHECKPOINT_RECORDS || checkpoint();
+    }
+
+    /**
+     * @brief Runs a checkpoint if the log holds any records, replayed or new.
+     * @return True unless a needed checkpoint failed.
+     */
+    bool checkpointIfChanged() {
+        return walRecords == 0 || checkpoint();
+    }
+
+    /**
+     * @brief Records an already validated mark without logging it.
+     * For bulk paths (batch, import) that checkpoint once when they finish.
+     * @param rollNo The roll number of the student.
+     * @param day The day to mark.
+     * @return True if the mark was new, false if it was a duplicate.
+     */
+    bool importMark(int rollNo, DayNum day) {
+        return insertDate(rollNo, day);
+    }
+
+    /**
+     * @brief Marks attendance for a given student on a specific date.
+     * @param rollNo The roll number of the student.
+     * @param date The date to mark attendance (e.g., "YYYY-MM-DD").
+     * @return A JSON string indicating success or error.
+     */
+    std::string markAttendance(int rollNo, const std::string& date) {
+        DayNum day;
+        if (!parseDate(date, day)) {
+            return invalidDateReply(date);
+        }
+
+        // Check if the student already has attendance marked for this date
+        const size_t studentsBefore = attendance.size();
+        if (insertDate(rollNo, day)) {
+            logRecord('M', rollNo, day, attendance.size() != studentsBefore); // Persist the mark; the snapshot is only rewritten at checkpoints
+            return "{\"status\": \"success\", \"message\": \"Attendance marked for Roll No: " + std::to_string(rollNo) + " on " + date + "\"}";
+        } else {
+            return "{\"status\": \"error\", \"message\": \"Attendance already marked for Roll No: " + std::to_string(rollNo) + " on " + date + "\"}";
+        }
+    }
+
+    /**
+     * @brief Removes a mark made by mistake.
+     * @param rollNo The roll number of the student.
+     * @param date The date to unmark (e.g., "YYYY-MM-DD").
+     * @return A JSON string indicating success or error.
+     */
+    std::string unmarkAttendance(int rollNo, const std::string& date) {
+        DayNum day;
+        if (!parseDate(date, day)) {
+            return invalidDateReply(date);
+        }
+
+        if (removeDate(rollNo, day)) {
+            logRecord('U', rollNo, day);
+            return "{\"status\": \"success\", \"message\": \"Attendance unmarked for Roll No: " + std::to_string(rollNo) + " on " + date + "\"}";
+        }
+        return "{\"status\": \"error\", \"message\": \"Attendance not marked for Roll No: " + std::to_string(rollNo) + " on " + date + "\"}";
+    }
+
+    /**
+     * @brief Views all marked attendance dates for a specific student.
+     * @param rollNo The roll number of the student.
+     * @return A JSON string with attendance data or an error message.
+     */
+    std::string viewAttendance(int rollNo) const {
+        return viewAttendance(rollNo, "", "");
+    }
+
+    /**
+     * @brief Views a student's marked dates within a date range.
+     * Only the slice of the student's sorted days that falls in the range is visited.
+     * @param rollNo The roll number of the student.
+     * @param fromDate First day to include (e.g., "YYYY-MM-DD"), or "" for no lower bound.
+     * @param toDate Last day to include, or "" for no upper bound.
+     * @return A JSON string with attendance data or an error message.
+     */
+    std::string viewAttendance(int rollNo, const std::string& fromDate, const std::string& toDate) const {
+        DayNum from, to;
+        const std::string error = parseDateRange(fromDate, toDate, from, to, true);
+        if (!error.empty()) return error;
+
+        // Check if the roll number exists in the table
+        const DaySet* days = attendance.find(rollNo);
+        if (days) {
+            std::stringstream ss;
+            ss << "{\"status\": \"success\", \"roll_no\": " << rollNo;
+            if (!fromDate.empty()) ss << ", \"from\": \"" << DateDictionary::text(from) << "\"";
+            if (!toDate.empty()) ss << ", \"to\": \"" << DateDictionary::text(to) << "\"";
+            ss << ", \"dates\": [";
+            bool first_date = true;
+            days->forEachInRange(from, to, [&](DayNum date) {
+                if (!first_date) {
+                    ss << ", ";
+                }
+                ss << "\"" << DateDictionary::text(date) << "\""; // Enclose dates in quotes for JSON string
+                first_date = false;
+            });
+            ss << "]}";
+            return ss.str();
+        } else {
+            return "{\"status\": \"error\", \"message\": \"Roll No: " + std::to_string(rollNo) + " not found.\"}";
+        }
+    }
+
+    /**
+     * @brief Lists the students present on one day, in roll number order.
+     * Answered from the day index, so the cost is proportional to the students present.
+     * @param date The day to report (e.g., "YYYY-MM-DD").
+     * @return A JSON string with the roll numbers or an error message.
+     */
+    std::string dayAttendance(const std::string& date) const {
+        DayNum day;
+        if (!parseDate(date, day)) {
+            return invalidDateReply(date);
+        }
+
+        std::stringstream ss;
+        ss << "{\"status\": \"success\", \"date\": \"" << DateDictionary::text(day) << "\", \"roll_nos\": [";
+        auto it = dayIndex.find(day);
+        size_t count = 0;
+        if (it != dayIndex.end()) {
+            it->second.forEach([&](int rollNo) {
+                if (count++ > 0) ss << ", ";
+                ss << rollNo;
+            });
+        }
+        ss << "], \"count\": " << count << "}";
+        return ss.str();
+    }
+
+    /**
+     * @brief Lists the students present on every one of the given days (AND of the day sets).
+     * @param dates The days to intersect (e.g., "YYYY-MM-DD").
+     * @return A JSON string with the roll numbers or an error message.
+     */
+    std::string presentOnAll(const std::vector<std::string>& dates) const {
+        std::vector<DayNum> days;
+        std::string error = parseDates(dates, days);
+        if (!error.empty()) return error;
+
+        RollBitmap result;
+        for (size_t i = 0; i < days.size(); ++i) {
+            auto it = dayIndex.find(days[i]);
+            if (it == dayIndex.end()) {
+                result = RollBitmap(); // Nobody was present that day
+                break;
+            }
+            result = i == 0 ? it->second : result.intersect(it->second);
+            if (result.empty()) break;
+        }
+        return rollSetJson(days, result);
+    }
+
+    /**
+     * @brief Lists the students present on at least one of the given days (OR of the day sets).
+     * @param dates The days to unite (e.g., "YYYY-MM-DD").
+     * @return A JSON string with the roll numbers or an error message.
+     */
+    std::string presentOnAny(const std::vector<std::string>& dates) const {
+        std::vector<DayNum> days;
+        std::string error = parseDates(dates, days);
+        if (!error.empty()) return error;
+
+        RollBitmap result;
+        for (DayNum day : days) {
+            auto it = dayIndex.find(day);
+            if (it != dayIndex.end()) result = result.unite(it->second);
+        }
+        return rollSetJson(days, result);
+    }
+
+    /**
+     * @brief Lists registered students with no mark on any of the given days
+     * (all students ANDNOT the union of the day sets).
+     * @param dates The days to check (e.g., "YYYY-MM-DD").
+     * @return A JSON string with the roll numbers or an error message.
+     */
+    std::string absentOn(const std::vector<std::string>& dates) const {
+        std::vector<DayNum> days;
+        std::string error = parseDates(dates, days);
+        if (!error.empty()) return error;
+
+        RollBitmap present;
+        for (DayNum day : days) {
+            auto it = dayIndex.find(day);
+            if (it != dayIndex.end()) present = present.unite(it->second);
+        }
+        return rollSetJson(days, allStudents.subtract(present));
+    }
+
+    /**
+     * @brief Repacks every structure into its tightest form, e.g. after load.
+     * The pool rounds each day list up to a size class, so day lists are copied
+     * out at their exact size onto the plain heap and the pool is released as a
+     * whole. Lists created afterwards use the heap as well: compact mode trades
+     * the pool's allocation speed for predictable memory use.
+     */
+    void compact() {
+        attendance.compact(&dayListHeap);
+        dayListPool.reset(); // Every list has moved out, release the pool in bulk
+
+        for (auto& day : dayIndex) day.second.compact();
+        allStudents.compact();
+        if (columns) columns->compact();
+        dailyCounts.shrink_to_fit();
+        walPending.shrink_to_fit();
+        walChanges.shrink_to_fit();
+    }
+
+    /**
+     * @brief Reports the memory held by each structure.
+     * @return A JSON string with byte counts.
+     */
+    std::string memoryStats() const {
+        const size_t rollIndexBytes = attendance.indexBytes();
+        const size_t slotBytes = attendance.slotBytes();
+        const size_t dayListBytes = attendance.dayBytes();
+        size_t dayIndexBytes = allStudents.bytes();
+        for (const auto& day : dayIndex) {
+            // std::map node: the value plus a color word and three links (estimate)
+            dayIndexBytes += sizeof(day) + 4 * sizeof(void*) + day.second.bytes();
+        }
+        const size_t columnBytes = columns ? columns->bytes() : 0;
+        const size_t dictionaryBytes = DateDictionary::bytes();
+        const size_t dailyCountBytes = dailyCounts.capacity() * sizeof(std::uint32_t);
+        // What day lists take from the heap (pool chunks included) stands in for them in the total
+        const size_t total = rollIndexBytes + slotBytes + dayListHeap.liveBytes + dayIndexBytes + columnBytes + dictionaryBytes + dailyCountBytes + walPending.capacity();
+
+        std::stringstream ss;
+        ss << "{\"status\": \"success\", \"memory\": {";
+        ss << "\"students\": " << attendance.size() << ", \"marks\": " << totalEntries << ", ";
+        ss << "\"roll_index_bytes\": " << rollIndexBytes << ", ";
+        ss << "\"student_slot_bytes\": " << slotBytes << ", ";
+        ss << "\"day_list_bytes\": " << dayListBytes << ", ";
+        ss << "\"day_list_heap_bytes\": " << dayListHeap.liveBytes << ", ";
+        ss << "\"day_index_bytes\": " << dayIndexBytes << ", ";
+        ss << "\"columnar_bytes\": " << columnBytes << ", ";
+        ss << "\"date_dictionary_bytes\": " << dictionaryBytes << ", ";
+        ss << "\"daily_count_bytes\": " << dailyCountBytes << ", ";
+        ss << "\"total_bytes\": " << total << ", ";
+        ss << "\"bytes_per_mark\": " << (totalEntries ? static_cast<double>(total) / totalEntries : 0.0);
+        ss << "}}";
+        return ss.str();
+    }
+
+    /**
+     * @brief Builds the columnar table now and keeps it in sync from here on.
+     */
+    void enableColumns() {
+        if (!columns) columns.reset(new AttendanceColumns());
+        columns->build(attendance);
+    }
+
+    /**
+     * @brief Summarizes all marks in a date range with a scan of the columnar table.
+     * The table is built on first use if --columnar was not given.
+     * @param fromDate First day of the range (e.g., "YYYY-MM-DD").
+     * @param toDate Last day of the range, inclusive.
+     * @return A JSON string with the summary or an error message.
+     */
+    std::string scanRange(const std::string& fromDate, const std::string& toDate) {
+        DayNum from, to;
+        const std::string error = parseDateRange(fromDate, toDate, from, to);
+        if (!error.empty()) return error;
+        if (!columns) enableColumns();
+        columns->merge();
+
+        size_t entries = 0, studentsPresent = 0, daysWithMarks = 0;
+        columns->countPerStudent(from, to, [&](int, size_t count) {
+            entries += count;
+            studentsPresent += count > 0;
+        });
+        // The day index already knows which days have marks
+        daysWithMarks = std::distance(dayIndex.lower_bound(from), dayIndex.upper_bound(to));
+
+        std::stringstream ss;
+        ss << "{\"status\": \"success\", \"from\": \"" << DateDictionary::text(from) << "\", \"to\": \"" << DateDictionary::text(to) << "\", ";
+        ss << "\"entries\": " << entries << ", \"students_present\": " << studentsPresent << ", ";
+        ss << "\"days_with_marks\": " << daysWithMarks << ", \"rows_scanned\": " << columns->rows() << "}";
+        return ss.str();
+    }
+
+    /**
+     * @brief Computes every student's attendance percentage over a date range.
+     * The denominator is the number of working days in the range from the
+     * calendar; the numerator is the student's marks on those working days, read
+     * from the slice of their sorted days in one pass over the student table.
+     * @param fromDate First day of the range (e.g., "YYYY-MM-DD").
+     * @param toDate Last day of the range, inclusive.
+     * @return A JSON string with per-student percentages or an error message.
+     */
+    std::string attendancePercentages(const std::string& fromDate, const std::string& toDate) const {
+        DayNum from, to;
+        const std::string error = parseDateRange(fromDate, toDate, from, to);
+        if (!error.empty()) return error;
+        const size_t workingDays = calendar.countWorking(from, to);
+        auto percentOf = [workingDays](size_t present) {
+            return workingDays ? std::round(10000.0 * present / workingDays) / 100 : 0.0; // Two decimals
+        };
+
+        std::stringstream ss;
+        ss << "{\"status\": \"success\", \"from\": \"" << DateDictionary::text(from) << "\", \"to\": \"" << DateDictionary::text(to) << "\", ";
+        ss << "\"working_days\": " << workingDays << ", \"calendar\": \"" << (calendar.isFromFile() ? CALENDAR_FILENAME : "weekdays") << "\", ";
+        ss << "\"students\": [";
+        size_t totalPresent = 0;
+        bool first = true;
+        for (std::uint32_t slot : attendance.rollOrder()) {
+            size_t present = 0;
+            attendance.daysAt(slot).forEachInRange(from, to, [&](DayNum day) { present += calendar.isWorking(day); });
+            totalPresent += present;
+            if (!first) ss << ", ";
+            ss << "{\"roll_no\": " << attendance.rollAt(slot) << ", \"present\": " << present << ", \"percent\": " << percentOf(present) << "}";
+            first = false;
+        }
+        const double average = attendance.size() && workingDays ? 100.0 * totalPresent / (static_cast<double>(workingDays) * attendance.size()) : 0.0;
+        ss << "], \"average_percent\": " << std::round(average * 100) / 100 << "}";
+        return ss.str();
+    }
+
+    /**
+     * @brief Reports presence streaks and absence runs over the working days of a range.
+     * Each student's marks are turned into a bitset with one bit per working day
+     * (via the calendar's rank) and analysed with computeStreaks(). The whole roster
+     * is split across hardware threads, which only read the student table.
+     * @param fromDate First day of the range (e.g., "YYYY-MM-DD").
+     * @param toDate Last day of the range, inclusive.
+     * @param rollNo A single student, or nullptr for every student.
+     * @return A JSON string with per-student figures or an error message.
+     */
+    std::string streaks(const std::string& fromDate, const std::string& toDate, const int* rollNo) const {
+        DayNum from, to;
+        const std::string error = parseDateRange(fromDate, toDate, from, to);
+        if (!error.empty()) return error;
+        std::vector<std::uint32_t> slots;
+        if (rollNo) {
+            const std::uint32_t slot = attendance.slotOf(*rollNo);
+            if (slot == RollIndex::NOT_FOUND) {
+                return "{\"status\": \"error\", \"message\": \"Roll No: " + std::to_string(*rollNo) + " not found.\"}";
+            }
+            slots.push_back(slot);
+        } else {
+            slots = attendance.rollOrder();
+        }
+
+        const size_t base = calendar.rank(from);
+        const size_t workingDays = calendar.countWorking(from, to);
+        std::vector<StreakStats> results(slots.size());
+        auto analyse = [&](size_t begin, size_t end) {
+            std::vector<std::uint64_t> presence((workingDays + 63) / 64 + 1);
+            for (size_t i = begin; i < end; ++i) {
+                std::fill(presence.begin(), presence.end(), 0);
+                attendance.daysAt(slots[i]).forEachInRange(from, to, [&](DayNum day) {
+                    if (!calendar.isWorking(day)) return;
+                    const size_t bit = calendar.rank(day) - base;
+                    presence[bit / 64] |= std::uint64_t(1) << (bit % 64);
+                });
+                results[i] = computeStreaks(presence, workingDays);
+            }
+        };
+
+        // At least a few thousand students per thread, so small rosters stay single-threaded
+        const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        const size_t threads = std::min(hardware, slots.size() / 2048 + 1);
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < threads; ++t) {
+            workers.emplace_back(analyse, slots.size() * t / threads, slots.size() * (t + 1) / threads);
+        }
+        analyse(0, slots.size() / threads);
+        for (std::thread& worker : workers) worker.join();
+
+        std::stringstream ss;
+        ss << "{\"status\": \"success\", \"from\": \"" << DateDictionary::text(from) << "\", \"to\": \"" << DateDictionary::text(to) << "\", ";
+        ss << "\"working_days\": " << workingDays << ", \"students\": [";
+        for (size_t i = 0; i < slots.size(); ++i) {
+            const StreakStats& r = results[i];
+            if (i > 0) ss << ", ";
+            ss << "{\"roll_no\": " << attendance.rollAt(slots[i]) << ", \"present\": " << r.present;
+            ss << ", \"longest_absence\": " << r.longestAbsence << ", \"absence_episodes\": " << r.absenceEpisodes;
+            ss << ", \"current_streak\": " << r.currentStreak << ", \"current_absence\": " << r.currentAbsence << "}";
+        }
+        ss << "]}";
+        return ss.str();
+    }
+
+    /**
+     * @brief Lists the K students with the fewest (or most) marks, optionally within a date range.
+     * One pass over the student table feeds a heap bounded at K entries, so the
+     * cost is O(students * log K) and the memory O(K) rather than a full sort.
+     * Ties are broken by roll number, ascending.
+     * @param k Number of students to return.
+     * @param lowest True for bottom-k (fewest marks), false for top-k.
+     * @param fromDate First day to count (e.g., "YYYY-MM-DD"), or "" for no lower bound.
+     * @param toDate Last day to count, or "" for no upper bound.
+     * @return A JSON string with the students in rank order or an error message.
+     */
+    std::string rankStudents(size_t k, bool lowest, const std::string& fromDate, const std::string& toDate) const {
+        DayNum from, to;
+        const std::string error = parseDateRange(fromDate, toDate, from, to, true);
+        if (!error.empty()) return error;
+        const bool ranged = !fromDate.empty() || !toDate.empty();
+
+        // (count, roll) ordered so that the heap top is the entry to evict first
+        typedef std::pair<size_t, int> Ranked;
+        auto before = [lowest](const Ranked& a, const Ranked& b) {
+            if (a.first != b.first) return lowest ? a.first < b.first : a.first > b.first;
+            return a.second < b.second;
+        };
+        std::priority_queue<Ranked, std::vector<Ranked>, decltype(before)> heap(before);
+        for (size_t slot = 0; k > 0 && slot < attendance.size(); ++slot) {
+            const DaySet& days = attendance.daysAt(slot);
+            const Ranked entry(ranged ? days.countInRange(from, to) : days.size(), attendance.rollAt(slot));
+            if (heap.size() < k) {
+                heap.push(entry);
+            } else if (before(entry, heap.top())) {
+                heap.pop();
+                heap.push(entry);
+            }
+        }
+        std::vector<Ranked> ranked;
+        ranked.reserve(heap.size());
+        for (; !heap.empty(); heap.pop()) ranked.push_back(heap.top());
+        std::reverse(ranked.begin(), ranked.end());
+
+        std::stringstream ss;
+        ss << "{\"status\": \"success\", \"order\": \"" << (lowest ? "bottom" : "top") << "\", \"k\": " << k;
+        if (!fromDate.empty()) ss << ", \"from\": \"" << DateDictionary::text(from) << "\"";
+        if (!toDate.empty()) ss << ", \"to\": \"" << DateDictionary::text(to) << "\"";
+        ss << ", \"students\": [";
+        for (size_t i = 0; i < ranked.size(); ++i) {
+            if (i > 0) ss << ", ";
+            ss << "{\"roll_no\": " << ranked[i].second << ", \"count\": " << ranked[i].first << "}";
+        }
+        ss << "]}";
+        return ss.str();
+    }
+
+    /**
+     * @brief Number of students present on each day of a range, read from the daily counters.
+     * @param fromDate First day of the range (e.g., "YYYY-MM-DD").
+     * @param toDate Last day of the range, inclusive.
+     * @return A JSON string with one count per day (zero for days without marks) or an error message.
+     */
+    std::string dailyCountSeries(const std::string& fromDate, const std::string& toDate) const {
+        DayNum from, to;
+        const std::string error = parseDateRange(fromDate, toDate, from, to);
+        if (!error.empty()) return error;
+        std::stringstream ss;
+        ss << "{\"status\": \"success\", \"from\": \"" << DateDictionary::text(from) << "\", \"to\": \"" << DateDictionary::text(to) << "\", \"counts\": [";
+        for (size_t day = from; day <= to; ++day) {
+            if (day > from) ss << ", ";
+            ss << (day >= dailyBase && day - dailyBase < dailyCounts.size() ? dailyCounts[day - dailyBase] : 0);
+        }
+        ss << "]}";
+        return ss.str();
+    }
+
+    /**
+     * @brief Returns overall attendance statistics in constant time.
+     * @return A JSON string containing statistics.
+     */
+    std::string getOverallStats() const {
+        // All three figures are maintained on mark, unmark and load; nothing is scanned here
+        std::stringstream ss;
+        ss << "{\"status\": \"success\", \"stats\": {";
+        ss << "\"total_students\": " << attendance.size() << ", "; // Number of unique roll numbers
+        ss << "\"total_unique_dates\": " << dayIndex.size() << ", "; // Days with at least one mark
+        ss << "\"total_attendance_entries\": " << totalEntries;
+        ss << "}}";
+        return ss.str();
+    }
+};
+
+/**
+ * @brief Reads the optional "--from <date>" and "--to <date>" arguments from args[first...].
+ * @return False if anything else is there, so the caller can print its usage line.
+ */
+bool parseRangeOptions(const std::vector<std::string>& args, size_t first, std::string& from, std::string& to) {
+    if (args.size() < first || (args.size() - first) % 2 != 0) return false;
+    for (size_t i = first; i < args.size(); i += 2) {
+        if (args[i] == "--from") from = args[i + 1];
+        else if (args[i] == "--to") to = args[i + 1];
+        else return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Runs one command against the system and returns its JSON result.
+ * Shared by the one-shot command line and the persistent server so both speak
+ * exactly the same commands.
+ * @param system The attendance system to operate on.
+ * @param args The command name followed by its arguments (e.g. {"mark", "5", "2025-07-08"}).
+ * @param modified Set to true when the command changed the attendance data.
+ * @return A JSON string with the command result.
+ */
+std::string runCommand(AttendanceSystem& system, const std::vector<std::string>& args, bool& modified) {
+    modified = false;
+    if (args.empty()) {
+        return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app <command> [args]\"}";
+    }
+
+    const std::string& command = args[0]; // The command name (e.g., "mark", "view", "stats")
+
+    if (command == "mark") {
+        // Expects: mark <roll_no> <date>
+        if (args.size() != 3) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app mark <roll_no> <date>\"}";
+        }
+        try {
+            int rollNo = std::stoi(args[1]); // Convert string argument to integer
+            std::string result_json = system.markAttendance(rollNo, args[2]);
+            modified = true;
+            return result_json;
+        } catch (const std::exception& e) {
+            return "{\"status\": \"error\", \"message\": \"Invalid roll number or date format: " + std::string(e.what()) + "\"}";
+        }
+    } else if (command == "unmark") {
+        // Expects: unmark <roll_no> <date>
+        if (args.size() != 3) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app unmark <roll_no> <date>\"}";
+        }
+        try {
+            int rollNo = std::stoi(args[1]);
+            std::string result_json = system.unmarkAttendance(rollNo, args[2]);
+            modified = true;
+            return result_json;
+        } catch (const std::exception& e) {
+            return "{\"status\": \"error\", \"message\": \"Invalid roll number or date format: " + std::string(e.what()) + "\"}";
+        }
+    } else if (command == "view") {
+        // Expects: view <roll_no> [--from <date>] [--to <date>]
+        std::string from, to;
+        if (!parseRangeOptions(args, 2, from, to)) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app view <roll_no> [--from <date>] [--to <date>]\"}";
+        }
+        try {
+            int rollNo = std::stoi(args[1]);
+            return system.viewAttendance(rollNo, from, to);
+        } catch (const std::exception& e) {
+            return "{\"status\": \"error\", \"message\": \"Invalid roll number format: " + std::string(e.what()) + "\"}";
+        }
+    } else if (command == "stats") {
+        // Expects: stats
+        if (args.size() != 1) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app stats\"}";
+        }
+        return system.getOverallStats();
+    } else if (command == "day") {
+        // Expects: day <date>
+        if (args.size() != 2) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app day <date>\"}";
+        }
+        return system.dayAttendance(args[1]);
+    } else if (command == "present-all" || command == "present-any" || command == "absent") {
+        // Expects: present-all|present-any|absent <date> [date...]
+        if (args.size() < 2) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app " + command + " <date> [date...]\"}";
+        }
+        const std::vector<std::string> dates(args.begin() + 1, args.end());
+        if (command == "present-all") return system.presentOnAll(dates);
+        if (command == "present-any") return system.presentOnAny(dates);
+        return system.absentOn(dates);
+    } else if (command == "scan") {
+        // Expects: scan <from_date> <to_date>
+        if (args.size() != 3) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app scan <from_date> <to_date>\"}";
+        }
+        return system.scanRange(args[1], args[2]);
+    } else if (command == "percent") {
+        // Expects: percent <from_date> <to_date>
+        if (args.size() != 3) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app percent <from_date> <to_date>\"}";
+        }
+        return system.attendancePercentages(args[1], args[2]);
+    } else if (command == "streaks") {
+        // Expects: streaks <from_date> <to_date> [roll_no]
+        if (args.size() != 3 && args.size() != 4) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app streaks <from_date> <to_date> [roll_no]\"}";
+        }
+        if (args.size() == 3) return system.streaks(args[1], args[2], nullptr);
+        try {
+            const int rollNo = std::stoi(args[3]);
+            return system.streaks(args[1], args[2], &rollNo);
+        } catch (const std::exception& e) {
+            return "{\"status\": \"error\", \"message\": \"Invalid roll number format: " + std::string(e.what()) + "\"}";
+        }
+    } else if (command == "top-k" || command == "bottom-k") {
+        // Expects: top-k|bottom-k <k> [--from <date>] [--to <date>]
+        std::string from, to;
+        if (!parseRangeOptions(args, 2, from, to)) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app " + command + " <k> [--from <date>] [--to <date>]\"}";
+        }
+        try {
+            const long k = std::stol(args[1]);
+            if (k < 0) throw std::invalid_argument("negative k");
+            return system.rankStudents(static_cast<size_t>(k), command == "bottom-k", from, to);
+        } catch (const std::exception& e) {
+            return "{\"status\": \"error\", \"message\": \"Invalid k: " + std::string(e.what()) + "\"}";
+        }
+    } else if (command == "daily") {
+        // Expects: daily <from_date> <to_date>
+        if (args.size() != 3) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app daily <from_date> <to_date>\"}";
+        }
+        return system.dailyCountSeries(args[1], args[2]);
+    } else if (command == "memstats") {
+        // Expects: memstats
+        if (args.size() != 1) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app memstats\"}";
+        }
+        return system.memoryStats();
+    } else if (command == "checkpoint") {
+        // Expects: checkpoint
+        if (args.size() != 1) {
+            return "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app checkpoint\"}";
+        }
+        if (!system.checkpoint()) {
+            return "{\"status\": \"error\", \"message\": \"Checkpoint failed\"}";
+        }
+        return "{\"status\": \"success\", \"message\": \"Checkpoint written\"}";
+    }
+
+    // Handle unknown commands
+    return "{\"status\": \"error\", \"message\": \"Unknown command: " + command + "\"}";
+}
+
+/**
+ * @brief Splits a request line into whitespace-separated tokens.
+ * @param line The request line (e.g. "mark 5 2025-07-08").
+ * @return The tokens of the line.
+ */
+std::vector<std::string> splitCommandLine(const std::string& line) {
+    std::vector<std::string> tokens;
+    std::stringstream ss(line);
+    std::string token;
+    while (ss >> token) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+/**
+ * @brief Imports marks from a CSV or TSV export (roll, date[, session]).
+ *
+ * The file is streamed through a fixed-size buffer, so memory stays flat no
+ * matter how large the input is. Fields may be separated by ',' or tab and
+ * may be quoted; a first line whose roll field is not a number is treated as
+ * a header. The optional session column is accepted but not stored, since
+ * attendance is tracked per day. Rows are validated, deduplicated against the
+ * existing data and applied in bulk, and the data is saved once at the end.
+ * @param system The loaded attendance system.
+ * @param path The CSV/TSV file to import.
+ * @return A JSON string with row counts and throughput.
+ */
+std::string runImport(AttendanceSystem& system, const std::string& path) {
+    std::ifstream inFile(path, std::ios::binary);
+    if (!inFile.is_open()) {
+        return "{\"status\": \"error\", \"message\": \"Could not open " + path + "\"}";
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    size_t rows = 0, imported = 0, duplicates = 0, rejected = 0;
+
+    // Splits one line into trimmed, unquoted fields and applies it
+    auto processLine = [&](const char* line, const char* lineEnd) {
+        if (lineEnd > line && lineEnd[-1] == '\r') --lineEnd;
+        const char* fields[3][2];
+        int count = 0;
+        for (const char* p = line; count < 3;) {
+            const char* fieldEnd = p;
+            while (fieldEnd < lineEnd && *fieldEnd != ',' && *fieldEnd != '\t') ++fieldEnd;
+            const char* a = p;
+            const char* b = fieldEnd;
+            while (a < b && (*a == ' ' || *a == '"')) ++a;
+            while (b > a && (b[-1] == ' ' || b[-1] == '"')) --b;
+            fields[count][0] = a;
+            fields[count][1] = b;
+            ++count;
+            if (fieldEnd == lineEnd) break;
+            p = fieldEnd + 1;
+        }
+        if (count == 1 && fields[0][0] == fields[0][1]) return; // Blank line
+
+        const bool firstRow = rows == 0 && imported == 0 && duplicates == 0 && rejected == 0;
+        ++rows;
+
+        long long rollNo = 0;
+        bool validRoll = fields[0][0] < fields[0][1] && fields[0][1] - fields[0][0] <= 10;
+        for (const char* p = fields[0][0]; validRoll && p < fields[0][1]; ++p) {
+            validRoll = *p >= '0' && *p <= '9';
+            rollNo = rollNo * 10 + (*p - '0');
+        }
+        if (!validRoll && firstRow) {
+            --rows; // Header line
+            return;
+        }
+
+        DayNum day;
+        if (!validRoll || rollNo <= 0 || rollNo > 2147483647LL || count < 2 ||
+            !parseDate(fields[1][0], fields[1][1] - fields[1][0], day)) {
+            ++rejected;
+            return;
+        }
+        if (system.importMark(static_cast<int>(rollNo), day)) {
+            ++imported;
+        } else {
+            ++duplicates;
+        }
+    };
+
+    // Stream the file in fixed-size chunks, carrying a partial last line over
+    std::vector<char> buffer(1 << 20);
+    size_t carried = 0;
+    while (true) {
+        inFile.read(buffer.data() + carried, buffer.size() - carried);
+        const size_t filled = carried + static_cast<size_t>(inFile.gcount());
+        if (filled == carried) break; // End of file
+
+        const char* p = buffer.data();
+        const char* end = buffer.data() + filled;
+        const char* newline;
+        while ((newline = static_cast<const char*>(std::memchr(p, '\n', end - p))) != nullptr) {
+            processLine(p, newline);
+            p = newline + 1;
+        }
+
+        carried = end - p;
+        if (carried == buffer.size()) {
+            // A single line fills the whole buffer: it cannot be a valid row
+            ++rows;
+            ++rejected;
+            carried = 0;
+            inFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            continue;
+        }
+        std::memmove(buffer.data(), p, carried);
+    }
+    if (carried > 0) {
+        processLine(buffer.data(), buffer.data() + carried); // Last line without '\n'
+    }
+
+    if (imported > 0 && !system.checkpoint()) {
+        return "{\"status\": \"error\", \"message\": \"Import applied but could not be saved\"}";
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::stringstream ss;
+    ss << "{\"status\": \"success\", \"import\": {";
+    ss << "\"rows\": " << rows << ", ";
+    ss << "\"imported\": " << imported << ", ";
+    ss << "\"duplicates\": " << duplicates << ", ";
+    ss << "\"rejected\": " << rejected << ", ";
+    ss << "\"seconds\": " << seconds << ", ";
+    ss << "\"rows_per_sec\": " << static_cast<long long>(seconds > 0 ? rows / seconds : rows);
+    ss << "}}";
+    return ss.str();
+}
+
+/**
+ * @brief Runs newline-delimited commands against one in-memory state.
+ * Each line is a command as it would be given on the command line (e.g.
+ * "mark 5 2025-07-08"); blank lines are skipped. One JSON result line is
+ * written per command, and the data is saved once at the end instead of
+ * after every mark.
+ * @param system The loaded attendance system.
+ * @param in Stream of command lines.
+ * @param out Stream for the JSON results.
+ * @return Process exit code.
+ */
+int runBatch(AttendanceSystem& system, std::istream& in, std::ostream& out) {
+    bool anyModified = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<std::string> args = splitCommandLine(line);
+        if (args.empty()) continue;
+
+        bool modified = false;
+        out << runCommand(system, args, modified) << '\n';
+        anyModified = anyModified || modified;
+    }
+    out.flush();
+
+    if (anyModified && !system.checkpoint()) {
+        std::cerr << "Error: Batch results could not be saved." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Microbenchmark of the roll number index: StudentTable versus std::map.
+ * Uses random, unique, sparse roll numbers (hashed) and, for the direct mode,
+ * contiguous roll numbers inserted in random order. Does not touch the data files.
+ * @param sizes Student counts to measure.
+ * @return A JSON string with nanoseconds per lookup and per scanned student.
+ */
+std::string runIndexBenchmark(const std::vector<size_t>& sizes) {
+    typedef std::chrono::steady_clock Clock;
+    auto nsPer = [](Clock::time_point start, size_t ops) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ops;
+    };
+    std::mt19937_64 rng(42);
+    volatile size_t sink = 0; // Keeps the measured loops from being optimized away
+
+    std::stringstream ss;
+    ss << "{\"status\": \"success\", \"benchmark\": \"index\", \"results\": [";
+    for (size_t n = 0; n < sizes.size(); ++n) {
+        const size_t students = sizes[n];
+
+        // Unique roll numbers spread over four times the student count
+        std::vector<int> rolls(students * 4);
+        for (size_t i = 0; i < rolls.size(); ++i) rolls[i] = static_cast<int>(i + 1);
+        std::shuffle(rolls.begin(), rolls.end(), rng);
+        rolls.resize(students);
+
+        std::map<int, DaySet> tree;
+        StudentTable table;
+        for (int rollNo : rolls) {
+            tree[rollNo].insert(static_cast<DayNum>(rollNo & 0x3FFF), std::pmr::get_default_resource());
+            table.insert(rollNo, static_cast<DayNum>(rollNo & 0x3FFF));
+        }
+
+        // Roll numbers 1..students, the common case served by the direct array
+        std::vector<int> denseRolls(students);
+        for (size_t i = 0; i < students; ++i) denseRolls[i] = static_cast<int>(i + 1);
+        std::shuffle(denseRolls.begin(), denseRolls.end(), rng);
+        StudentTable denseTable;
+        for (int rollNo : denseRolls) denseTable.insert(rollNo, static_cast<DayNum>(rollNo & 0x3FFF));
+
+        const size_t lookups = 2000000;
+        std::vector<int> queries(lookups);
+        for (int& q : queries) q = rolls[rng() % students];
+
+        size_t found = 0;
+        Clock::time_point start = Clock::now();
+        for (int q : queries) found += tree.find(q)->second.size();
+        const double treeLookup = nsPer(start, lookups);
+
+        start = Clock::now();
+        for (int q : queries) found += table.find(q)->size();
+        const double tableLookup = nsPer(start, lookups);
+
+        for (size_t i = 0; i < lookups; ++i) queries[i] = denseRolls[rng() % students];
+        start = Clock::now();
+        for (int q : queries) found += denseTable.find(q)->size();
+        const double denseLookup = nsPer(start, lookups);
+
+        const size_t passes = std::max<size_t>(1, 20000000 / students);
+        start = Clock::now();
+        for (size_t p = 0; p < passes; ++p) {
+            for (const auto& pair : tree) found += pair.second.size();
+        }
+        const double treeScan = nsPer(start, passes * students);
+
+        start = Clock::now();
+        for (size_t p = 0; p < passes; ++p) {
+            for (size_t slot = 0; slot < table.size(); ++slot) found += table.daysAt(slot).size();
+        }
+        const double tableScan = nsPer(start, passes * students);
+        sink = sink + found;
+
+        if (n > 0) ss << ", ";
+        ss << "{\"students\": " << students;
+        ss << ", \"map_lookup_ns\": " << treeLookup << ", \"flat_lookup_ns\": " << tableLookup;
+        ss << ", \"direct_lookup_ns\": " << denseLookup;
+        ss << ", \"map_scan_ns_per_student\": " << treeScan << ", \"flat_scan_ns_per_student\": " << tableScan << "}";
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+/**
+ * @brief Counts heap allocations of the per-student day lists on the load and
+ * import paths, with lists on the plain heap versus the pool AttendanceSystem uses.
+ * Builds a synthetic JSON file in memory and does not touch the data files.
+ * @param students Number of students in the synthetic file.
+ * @param days Marks per student.
+ * @return A JSON string with allocation counts and timings per mode.
+ */
+std::string runAllocBenchmark(size_t students, size_t days) {
+    typedef std::chrono::steady_clock Clock;
+    auto msSince = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+    const DayNum firstDay = static_cast<DayNum>(daysFromCivil(2023, 1, 2));
+
+    // Same layout saveData() writes: {"1":["2023-01-02",...],...}
+    std::string json = "{";
+    for (size_t s = 0; s < students; ++s) {
+        if (s > 0) json += ',';
+        json += '"' + std::to_string(s + 1) + "\":[";
+        for (size_t d = 0; d < days; ++d) {
+            if (d > 0) json += ',';
+            json += '"';
+            json += DateDictionary::text(static_cast<DayNum>(firstDay + d));
+            json += '"';
+        }
+        json += ']';
+    }
+    json += '}';
+
+    std::stringstream ss;
+    ss << "{\"status\": \"success\", \"benchmark\": \"alloc\", \"students\": " << students << ", \"days\": " << days
+       << ", \"json_bytes\": " << json.size() << ", \"results\": [";
+    for (int pooled = 0; pooled < 2; ++pooled) {
+        CountingResource heap(std::pmr::new_delete_resource());
+        std::unique_ptr<std::pmr::unsynchronized_pool_resource> pool;
+        if (pooled) pool.reset(new std::pmr::unsynchronized_pool_resource(&heap));
+        std::pmr::memory_resource* resource = pooled ? static_cast<std::pmr::memory_resource*>(pool.get()) : &heap;
+
+        size_t loadAllocations = 0, importAllocations = 0;
+        double loadMs = 0, importMs = 0, releaseMs = 0;
+        {
+            // Load path: the JSON loader, one sorted array per student
+            StudentTable loaded(resource);
+            Clock::time_point start = Clock::now();
+            AttendanceJsonParser parser(json.data(), json.size());
+            scanAttendanceJson(json.data(), json.size(), parser, [&loaded](int rollNo, const std::vector<DayNum>& list) {
+                loaded.insertSorted(rollNo, list.data(), list.size());
+            });
+            loadMs = msSince(start);
+            loadAllocations = heap.allocations;
+
+            // Import path: one mark at a time in day-major order, as a CSV export arrives
+            StudentTable imported(resource);
+            start = Clock::now();
+            for (size_t d = 0; d < days; ++d) {
+                for (size_t s = 0; s < students; ++s) imported.insert(static_cast<int>(s + 1), static_cast<DayNum>(firstDay + d));
+            }
+            importMs = msSince(start);
+            importAllocations = heap.allocations - loadAllocations;
+
+            start = Clock::now();
+            loaded.clear();
+            imported.clear();
+            pool.reset(); // Bulk release
+            releaseMs = msSince(start);
+        }
+
+        if (pooled) ss << ", ";
+        ss << "{\"mode\": \"" << (pooled ? "pool" : "heap") << "\", \"load_allocations\": " << loadAllocations
+           << ", \"import_allocations\": " << importAllocations << ", \"allocated_bytes\": " << heap.allocatedBytes
+           << ", \"load_ms\": " << loadMs << ", \"import_ms\": " << importMs << ", \"release_ms\": " << releaseMs << "}";
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+#ifndef _WIN32
+// Set by SIGINT/SIGTERM so the server loop can shut down cleanly
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handleStopSignal(int) {
+    stop_requested = 1;
+}
+
+/**
+ * @brief Puts a descriptor in non-blocking mode.
+ */
+static bool setNonBlocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief Serves commands over a Unix-domain socket until SIGINT/SIGTERM.
+ *
+ * Data is loaded once and stays resident, so each request costs only the command
+ * itself. The protocol is line framed: a client sends one command per line
+ * ("mark 5 2025-07-08\n") and receives exactly one JSON line back. Several
+ * clients may be connected at once; requests are handled one at a time by a
+ * single poll() loop, so the attendance map needs no locking. Client sockets
+ * are non-blocking and replies are queued per client and flushed on POLLOUT,
+ * so a client that stops reading only stalls itself.
+ * @param system The loaded attendance system.
+ * @param socketPath Filesystem path of the listening socket.
+ * @return Process exit code.
+ */
+int serve(AttendanceSystem& system, const std::string& socketPath) {
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Error: Socket path too long: " << socketPath << std::endl;
+        return 1;
+    }
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "Error: Could not create socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(socketPath.c_str()); // Remove a stale socket left by a previous run
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listenFd, 64) < 0 || !setNonBlocking(listenFd)) {
+        std::cerr << "Error: Could not listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        close(listenFd);
+        return 1;
+    }
+
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+    signal(SIGPIPE, SIG_IGN); // A client hanging up must not kill the server
+
+    struct Client {
+        std::string input;  // Bytes received but not yet terminated by '\n'
+        std::string output; // Reply bytes not yet accepted by the socket
+        size_t sent = 0;    // Bytes of output already written
+        bool closing = false; // Drop the client once output is flushed
+    };
+    std::map<int, Client> clients;
+    std::vector<pollfd> fds;
+    char buf[4096];
+
+    std::cerr << "attendance_app serving on " << socketPath << std::endl;
+    while (!stop_requested) {
+        // Listen for requests only from clients that are keeping up with their replies
+        fds.assign(1, pollfd{listenFd, POLLIN, 0});
+        for (const auto& entry : clients) {
+            const Client& client = entry.second;
+            short events = 0;
+            if (!client.closing && client.output.size() - client.sent < SERVE_MAX_QUEUED_REPLY) events |= POLLIN;
+            if (client.sent < client.output.size()) events |= POLLOUT;
+            fds.push_back({entry.first, events, 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: poll failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        // Accept new clients
+        if (fds[0].revents & POLLIN) {
+            int clientFd;
+            while ((clientFd = accept(listenFd, nullptr, nullptr)) >= 0) {
+                if (setNonBlocking(clientFd)) {
+                    clients[clientFd];
+                } else {
+                    close(clientFd);
+                }
+            }
+        }
+
+        // Read from clients and run every complete request line. Replies are held back
+        // until the marks of this whole round are durable (group commit, see syncLog).
+        struct Reply { int fd; std::string json; bool modified; };
+        std::vector<Reply> replies;
+        std::vector<int> dropped;
+        for (size_t i = 1; i < fds.size(); ++i) {
+            const int fd = fds[i].fd;
+            Client& client = clients[fd];
+            if (fds[i].revents & (POLLERR | POLLNVAL)) {
+                dropped.push_back(fd);
+                continue;
+            }
+            if (!(fds[i].revents & (POLLIN | POLLHUP))) continue;
+
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) continue;
+            if (n <= 0) {
+                dropped.push_back(fd); // EOF or read error
+                continue;
+            }
+            client.input.append(buf, n);
+            size_t start = 0;
+            size_t newline;
+            while ((newline = client.input.find('\n', start)) != std::string::npos) {
+                bool modified = false;
+                std::string response = runCommand(system, splitCommandLine(client.input.substr(start, newline - start)), modified);
+                replies.push_back({fd, response, modified});
+                start = newline + 1;
+            }
+            client.input.erase(0, start);
+            if (client.input.size() > SERVE_MAX_REQUEST_LINE) {
+                replies.push_back({fd, "{\"status\": \"error\", \"message\": \"Request line too long\"}", false});
+                client.input.clear();
+                client.closing = true;
+            }
+        }
+        for (int fd : dropped) {
+            close(fd);
+            clients.erase(fd);
+        }
+
+        // One fsync for every mark of the round, then queue the acknowledgements
+        const bool durable = system.syncLog();
+        for (Reply& reply : replies) {
+            auto it = clients.find(reply.fd);
+            if (it == clients.end()) continue; // Client went away in this round
+            if (reply.modified && !durable) {
+                reply.json = "{\"status\": \"error\", \"message\": \"Attendance could not be saved\"}";
+            }
+            it->second.output += reply.json;
+            it->second.output += '\n';
+        }
+
+        // Write as much of each queue as the sockets accept without blocking
+        for (auto it = clients.begin(); it != clients.end();) {
+            Client& client = it->second;
+            bool failed = false;
+            while (client.sent < client.output.size()) {
+                ssize_t n = write(it->first, client.output.data() + client.sent, client.output.size() - client.sent);
+                if (n < 0) {
+                    failed = errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+                    break;
+                }
+                client.sent += static_cast<size_t>(n);
+            }
+            if (client.sent == client.output.size()) {
+                client.output.clear();
+                client.sent = 0;
+            }
+            if (failed || (client.closing && client.output.empty())) {
+                close(it->first);
+                it = clients.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        system.checkpointIfNeeded();
+    }
+
+    for (const auto& entry : clients) {
+        close(entry.first);
+    }
+    close(listenFd);
+    unlink(socketPath.c_str());
+    system.checkpointIfChanged(); // Fold the log into the snapshot on clean shutdown
+    return 0;
+}
+#endif
+
+// Main function now acts as a command-line interface for the Flask app
+int main(int argc, char* argv[]) {
+    // This static instance will persist data across calls within the same process
+    // For a real-world scenario, you'd use a database or persistent storage.
+    static AttendanceSystem system;
+
+    // Global options come before the command
+    int argi = 1;
+    bool columnar = false;
+    bool compact = false;
+    while (argi < argc) {
+        const std::string option = argv[argi];
+        if (option == "--term" && argi + 1 < argc) {
+            // --term <YYYY-MM-DD>: store each student's days in that term as a bitset
+            DayNum termStart;
+            if (!parseDate(argv[argi + 1], termStart)) {
+                std::cout << "{\"status\": \"error\", \"message\": \"Invalid term start date. Use YYYY-MM-DD\"}" << std::endl;
+                return 1;
+            }
+            DaySet::setTerm(termStart);
+            argi += 2;
+        } else if (option == "--columnar") {
+            // --columnar: build the columnar table at load instead of on the first scan
+            columnar = true;
+            ++argi;
+        } else if (option == "--compact") {
+            // --compact: repack everything into its tightest form after load
+            compact = true;
+            ++argi;
+        } else {
+            break;
+        }
+    }
+
+    if (argi < argc && std::string(argv[argi]) == "bench") {
+        // Expects: ./attendance_app bench index [students...]
+        //      or: ./attendance_app bench alloc [students] [days]   (neither loads or locks the data)
+        const std::string kind = argi + 1 < argc ? argv[argi + 1] : "";
+        if ((kind != "index" && kind != "alloc") || (kind == "alloc" && argc - argi > 4)) {
+            std::cout << "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app bench index [students...] | bench alloc [students] [days]\"}" << std::endl;
+            return 1;
+        }
+        std::vector<size_t> sizes;
+        try {
+            for (int i = argi + 2; i < argc; ++i) sizes.push_back(std::stoul(argv[i]));
+        } catch (const std::exception& e) {
+            std::cout << "{\"status\": \"error\", \"message\": \"Invalid count: " << e.what() << "\"}" << std::endl;
+            return 1;
+        }
+        if (kind == "alloc") {
+            const size_t students = sizes.size() > 0 ? sizes[0] : 20000;
+            const size_t days = sizes.size() > 1 ? std::min<size_t>(sizes[1], 10000) : 300;
+            std::cout << runAllocBenchmark(students, days) << std::endl;
+            return 0;
+        }
+        if (sizes.empty()) sizes = {10000, 100000, 1000000};
+        std::cout << runIndexBenchmark(sizes) << std::endl;
+        return 0;
+    }
+
+    // Only one process at a time may read and write the data files
+    if (!lockDataFiles()) {
+        std::cout << "{\"status\": \"error\", \"message\": \"Attendance data is locked by another process (is attendance_app serve running?)\"}" << std::endl;
+        return 1;
+    }
+
+    // Load data at the beginning of each execution: snapshot first, then marks logged since
+    system.loadData();
+    system.replayLog();
+    if (columnar) system.enableColumns();
+    if (compact) system.compact();
+
+    // Check for minimum arguments (command name)
+    if (argc <= argi) {
+        std::cout << "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app <command> [args]\"}" << std::endl;
+        return 1; // Indicate error
+    }
+
+    std::vector<std::string> args(argv + argi, argv + argc); // The command (e.g., "mark", "view", "stats") and its arguments
+
+    if (args[0] == "batch") {
+        // Expects: ./attendance_app batch [commands_file]   (stdin when no file is given)
+        // Batch saves once at the end, so marks are not logged one by one
+        if (args.size() > 2) {
+            std::cout << "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app batch [commands_file]\"}" << std::endl;
+            return 1;
+        }
+        if (args.size() == 2) {
+            std::ifstream commands(args[1]);
+            if (!commands.is_open()) {
+                std::cout << "{\"status\": \"error\", \"message\": \"Could not open " << args[1] << "\"}" << std::endl;
+                return 1;
+            }
+            return runBatch(system, commands, std::cout);
+        }
+        return runBatch(system, std::cin, std::cout);
+    }
+
+    if (args[0] == "import") {
+        // Expects: ./attendance_app import <csv_file>
+        // Like batch, the import is applied in memory and saved once
+        if (args.size() != 2) {
+            std::cout << "{\"status\": \"error\", \"message\": \"Usage: ./attendance_app import <csv_file>\"}" << std::endl;
+            return 1;
+        }
+        std::cout << runImport(system, args[1]) << std::endl;
+        return 0;
+    }
+
+    system.openLog();
+
+    if (args[0] == "serve") {
+        // Expects: ./attendance_app serve [socket_path]
+#ifndef _WIN32
+        return serve(system, args.size() > 1 ? args[1] : DEFAULT_SOCKET_PATH);
+#else
+        std::cout << "{\"status\": \"error\", \"message\": \"serve is not supported on this platform\"}" << std::endl;
+        return 1;
+#endif
+    }
+
+    bool modified = false;
+    std::string result_json = runCommand(system, args, modified);
+    if (modified) {
+        // Make the logged mark durable; rewrite the snapshot only when the log is long
+        if (!system.syncLog()) {
+            result_json = "{\"status\": \"error\", \"message\": \"Attendance could not be saved\"}";
         }
-    } else {
-        // Handle unknown commands
-        result_json = "{\"status\": \"error\", \"message\": \"Unknown command: " + command + "\"}";
+        system.checkpointIfNeeded();
     }
 
     std::cout << result_json << std::endl; // Output JSON to stdout
@@ -0,0 +1,141 @@
+#!/usr/bin/env bash
+# Checks the columnar table (AttendanceColumns) against a plain set model.
+#
+# Builds attendance_system.cpp, then drives "batch" with marks and unmarks
+# interleaved with "scan" queries, comparing entries, students_present,
+# days_with_marks and rows_scanned with a Python model. Between scans the
+# marks are shaped to exercise the pending deltas:
+#   - a mark and its unmark (and the reverse) cancelling before a merge;
+#   - the same mark flipped many times, and duplicates that must not log;
+#   - more than MERGE_THRESHOLD deltas, forcing an eager merge;
+#   - columns built on the first scan and, with --columnar, at load.
+#
+# Usage: tests/check_columns.sh   (from core_logic/; needs g++ with C++17 and python3)
+
+set -u
+
+here="$(cd "$(dirname "$0")/.." && pwd)"
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+g++ -std=c++17 -O2 -pthread "$here/attendance_system.cpp" -o "$work/attendance_app" || exit 1
+
+python3 - "$work/attendance_app" "$work/run" <<'EOF'
+import datetime, json, os, random, subprocess, sys
+
+app, run = sys.argv[1], sys.argv[2]
+os.mkdir(run)
+rng = random.Random(18)
+failures = 0
+
+start = datetime.date(2025, 7, 1)
+days = [(start + datetime.timedelta(d)).isoformat() for d in range(40)]
+marks = set() # The model: (roll, day index) pairs
+
+commands, expected = [], []
+
+def mark(roll, d):
+    commands.append('mark %d %s' % (roll, days[d]))
+    expected.append('success' if (roll, d) not in marks else 'error')
+    marks.add((roll, d))
+
+def unmark(roll, d):
+    commands.append('unmark %d %s' % (roll, days[d]))
+    expected.append('success' if (roll, d) in marks else 'error')
+    marks.discard((roll, d))
+
+def scan(first, last):
+    commands.append('scan %s %s' % (days[first], days[last]))
+    inside = [(roll, d) for roll, d in marks if first <= d <= last]
+    expected.append({'entries': len(inside),
+                     'students_present': len({roll for roll, _ in inside}),
+                     'days_with_marks': len({d for _, d in inside}),
+                     'rows_scanned': len(marks)})
+
+def scans():
+    scan(0, len(days) - 1)
+    for _ in range(4):
+        first = rng.randrange(len(days))
+        scan(first, rng.randrange(first, len(days)))
+
+def run_batch(options=()):
+    global commands, expected, failures
+    with open(os.path.join(run, 'commands.txt'), 'w') as f:
+        f.write('\n'.join(commands) + '\n')
+    out = subprocess.run([app] + list(options) + ['batch', 'commands.txt'], cwd=run,
+                         capture_output=True, text=True)
+    replies = out.stdout.splitlines()
+    if out.returncode != 0 or len(replies) != len(commands):
+        print('FAIL: batch exited %d with %d replies for %d commands: %s'
+              % (out.returncode, len(replies), len(commands), out.stderr.strip()))
+        sys.exit(1)
+    for command, reply, want in zip(commands, replies, expected):
+        got = json.loads(reply)
+        if isinstance(want, str):
+            ok = got['status'] == want
+        else:
+            ok = got['status'] == 'success' and all(got[key] == value for key, value in want.items())
+        if not ok:
+            failures += 1
+            if failures <= 10:
+                print('FAIL: %s%s: got %s, want %s' % (' '.join(options) + ' ' if options else '', command, reply, want))
+    commands, expected = [], []
+
+def churn(rolls, count):
+    """Random marks and unmarks, biased towards flipping recent ones so deltas cancel."""
+    recent = []
+    for _ in range(count):
+        if recent and rng.random() < 0.4:
+            roll, d = rng.choice(recent)
+        else:
+            roll, d = rng.choice(rolls), rng.randrange(len(days))
+            recent = (recent + [(roll, d)])[-20:]
+        (unmark if (roll, d) in marks and rng.random() < 0.7 else mark)(roll, d)
+
+rolls = list(range(1, 301)) + [-7, -2147483648, 2147483647]
+
+# Run 1: columns built by the first scan, then deltas between scans
+churn(rolls, 3000)
+scans()
+for _ in range(20):
+    churn(rolls, rng.randrange(1, 200))
+    scans()
+for _ in range(5):                       # One mark flipped back and forth
+    mark(42, 3)
+    unmark(42, 3)
+    unmark(42, 3)
+scans()
+for roll in (-2147483648, 2147483647):   # Removed then re-added before a merge
+    unmark(roll, 0)
+    mark(roll, 0)
+    mark(roll, 0)
+scans()
+run_batch()
+
+# Run 2: columns built at load; more deltas than MERGE_THRESHOLD between two scans
+churn(rolls, 500)
+scans()
+for roll in range(1000, 1000 + 1800):
+    for d in range(40):
+        mark(roll, d)
+scans()
+for roll in range(1000, 1000 + 1800, 3):
+    for d in range(0, 40, 2):
+        unmark(roll, d)
+churn(rolls, 1000)
+scans()
+run_batch(['--columnar'])
+
+# Run 3: reloaded, compacted, then small deltas
+scans()
+churn(rolls + list(range(1000, 1100)), 2000)
+scans()
+run_batch(['--columnar', '--compact'])
+
+if failures:
+    print('%d check(s) failed' % failures)
+    sys.exit(1)
+EOF
+status=$?
+[ "$status" -eq 0 ] && echo "columnar checks passed"
+exit "$status"
@@ -0,0 +1,127 @@
+#!/usr/bin/env bash
+# Checks the JSON loader under every classification kernel.
+#
+# Builds attendance_system.cpp, then loads the same inputs with
+# ATTENDANCE_SIMD=scalar, sse2 and avx2 (a kernel the CPU lacks falls back to
+# the next one down, see selectClassifyBlock):
+#   - valid files whose strings, escapes and structurals land on every offset of
+#     a 64-byte block must load to the same data under every kernel, and that
+#     data must match the expected view of every student;
+#   - invalid dates are skipped on load, but checkpoint must refuse to save
+#     (and so drop them) and leave the file as it was;
+#   - malformed files must be rejected with the same byte offset and message
+#     under every kernel.
+#
+# Usage: tests/check_loader.sh   (from core_logic/; needs g++ with C++17)
+
+set -u
+
+here="$(cd "$(dirname "$0")/.." && pwd)"
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+g++ -std=c++17 -O2 -pthread "$here/attendance_system.cpp" -o "$work/attendance_app" || exit 1
+
+kernels="scalar sse2 avx2"
+failures=0
+
+fail() {
+    echo "FAIL: $*"
+    failures=$((failures + 1))
+}
+
+# Loads $1 with kernel $2 and prints the reply to each "view" command in $3.
+load_views() {
+    local dir="$work/run"
+    rm -rf "$dir" && mkdir "$dir"
+    cp "$1" "$dir/attendance_data.json"
+    (cd "$dir" && ATTENDANCE_SIMD="$2" "$work/attendance_app" batch "$3" 2> /dev/null)
+}
+
+# Loads $1 with kernel $2 and prints the loader's error line.
+load_error() {
+    local dir="$work/run"
+    rm -rf "$dir" && mkdir "$dir"
+    cp "$1" "$dir/attendance_data.json"
+    (cd "$dir" && ATTENDANCE_SIMD="$2" "$work/attendance_app" stats 2>&1 > /dev/null | grep '^Error:')
+}
+
+# Valid input: pad each student with 0..63 spaces so every token crosses every
+# block offset, and mix in escaped quotes, backslash runs (inside invalid dates,
+# which are skipped), unquoted and negative roll numbers, empty arrays, unsorted
+# and repeated dates.
+valid="$work/valid.json"
+views="$work/views.txt"
+expected="$work/expected.txt"
+{
+    printf '{'
+    for pad in $(seq 0 63); do
+        printf '%*s"%d"%*s:%*s["2025-07-%02d", "2025-07-01" ,"bad\\"%*s\\\\", "2025-07-%02d"]' \
+            "$pad" '' "$((pad + 1))" "$((pad % 3))" '' "$((pad % 5))" '' "$((pad % 28 + 1))" "$pad" '' "$((pad % 28 + 1))"
+        printf ',\n'
+    done
+    printf ' -2147483648 : [ ] , 2147483647:["2149-06-06"]\t}\n'
+} > "$valid"
+{
+    printf 'view -2147483648\n'
+    for pad in $(seq 0 63); do
+        printf 'view %d\n' "$((pad + 1))"
+    done
+    printf 'view 2147483647\n'
+} > "$views"
+{
+    printf '{"status": "success", "roll_no": -2147483648, "dates": []}\n'
+    for pad in $(seq 0 63); do
+        day=$((pad % 28 + 1))
+        if [ "$day" -eq 1 ]; then
+            printf '{"status": "success", "roll_no": %d, "dates": ["2025-07-01"]}\n' "$((pad + 1))"
+        else
+            printf '{"status": "success", "roll_no": %d, "dates": ["2025-07-01", "2025-07-%02d"]}\n' "$((pad + 1))" "$day"
+        fi
+    done
+    printf '{"status": "success", "roll_no": 2147483647, "dates": ["2149-06-06"]}\n'
+} > "$expected"
+
+for kernel in $kernels; do
+    if ! load_views "$valid" "$kernel" "$views" | cmp -s - "$expected"; then
+        fail "valid input loads differently under ATTENDANCE_SIMD=$kernel"
+    fi
+done
+
+# Invalid dates: checkpoint must refuse, naming the first one, and keep the file
+printf '{"1":["2025-07-01","2025-13-45"],"2":["1969-12-31"]}' > "$work/invalid_dates.json"
+dir="$work/run"
+rm -rf "$dir" && mkdir "$dir"
+cp "$work/invalid_dates.json" "$dir/attendance_data.json"
+got="$(cd "$dir" && "$work/attendance_app" checkpoint 2>&1 > /dev/null | grep '^Error:')"
+[ "$got" = 'Error: Not saving: attendance_data.json has 2 invalid date(s), first "2025-13-45" for Roll No 1; fix or remove them first' ] ||
+    fail "checkpoint with invalid dates: got '$got'"
+cmp -s "$dir/attendance_data.json" "$work/invalid_dates.json" || fail "checkpoint rewrote a file with invalid dates"
+
+# Malformed inputs, each with the error the loader must report
+check_malformed() {
+    local name="$1" content="$2" want="$3"
+    printf '%s' "$content" > "$work/$name.json"
+    for kernel in $kernels; do
+        got="$(load_error "$work/$name.json" "$kernel")"
+        [ "$got" = "Error: Invalid JSON format in attendance_data.json at byte $want" ] ||
+            fail "$name under ATTENDANCE_SIMD=$kernel: got '$got', want 'at byte $want'"
+    done
+}
+
+long_pad="$(printf '%*s' 70 '')"
+check_malformed truncated '{"1":["2025-07-01"' '18: unexpected end of file'
+check_malformed no_object '["2025-07-01"]' '0: expected '"'"'{'"'"''
+check_malformed missing_colon '{"1" ["2025-07-01"]}' '5: expected '"'"':'"'"''
+check_malformed bad_roll '{"1x":["2025-07-01"]}' '1: invalid roll number'
+check_malformed roll_overflow '{"2147483648":[]}' '1: invalid roll number'
+check_malformed unquoted_date '{"1":[20250701]}' '6: expected date string'
+check_malformed missing_comma "{\"1\":[\"2025-07-01\"$long_pad\"2025-07-02\"]}" '88: expected '"'"','"'"' or '"'"']'"'"''
+check_malformed escaped_close "{\"1\":[\"2025-07-01\\\"]}" '21: unexpected end of file'
+check_malformed trailing '{"1":[]} {}' '9: unexpected content after '"'"'}'"'"''
+
+if [ "$failures" -ne 0 ]; then
+    echo "$failures check(s) failed"
+    exit 1
+fi
+echo "loader checks passed ($kernels)"
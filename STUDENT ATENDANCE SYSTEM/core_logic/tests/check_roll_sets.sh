@@ -0,0 +1,153 @@
+#!/usr/bin/env bash
+# Checks the per-day roll number sets (RollBitmap) against a plain set model.
+#
+# Builds attendance_system.cpp, then drives "batch" with marks, unmarks and
+# day/present-all/present-any/absent queries, comparing every reply with a
+# Python model. The data is shaped to walk each container through its forms:
+#   - arrays that grow past ARRAY_MAX into bitmaps, and shrink back;
+#   - dense ranges that become runs when a later run loads them
+#     (rebuildIndexes calls runOptimize), then are marked and unmarked
+#     (makeMutable);
+#   - containers spread over many high keys, including INT_MIN, INT_MAX and
+#     negative roll numbers, that are emptied and dropped;
+#   - AND/OR/ANDNOT between every pair of forms, with --compact as well.
+#
+# Usage: tests/check_roll_sets.sh   (from core_logic/; needs g++ with C++17 and python3)
+
+set -u
+
+here="$(cd "$(dirname "$0")/.." && pwd)"
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+g++ -std=c++17 -O2 -pthread "$here/attendance_system.cpp" -o "$work/attendance_app" || exit 1
+
+python3 - "$work/attendance_app" "$work/run" <<'EOF'
+import json, os, random, subprocess, sys
+
+app, run = sys.argv[1], sys.argv[2]
+os.mkdir(run)
+rng = random.Random(17)
+failures = 0
+
+days = ['2025-07-%02d' % d for d in range(1, 7)]
+present = {day: set() for day in days}  # The model: roll numbers present per day
+registered = set()                      # Students stay registered with no days left
+
+commands, expected = [], []
+
+def mark(roll, day):
+    commands.append('mark %d %s' % (roll, day))
+    new = roll not in present[day]
+    expected.append(('status', 'success' if new else 'error'))
+    present[day].add(roll)
+    registered.add(roll)
+
+def unmark(roll, day):
+    commands.append('unmark %d %s' % (roll, day))
+    expected.append(('status', 'success' if roll in present[day] else 'error'))
+    present[day].discard(roll)
+
+def query(command, picked):
+    commands.append(' '.join([command] + picked))
+    if command == 'day':
+        rolls = present[picked[0]]
+    elif command == 'present-all':
+        rolls = set.intersection(*(present[d] for d in picked))
+    elif command == 'present-any':
+        rolls = set.union(*(present[d] for d in picked))
+    else:
+        rolls = registered - set.union(*(present[d] for d in picked))
+    expected.append(('rolls', sorted(rolls)))
+
+def queries():
+    for day in days:
+        query('day', [day])
+    for _ in range(6):
+        picked = rng.sample(days, rng.randint(1, 4))
+        for command in ('present-all', 'present-any', 'absent'):
+            query(command, picked)
+
+def run_batch(options=()):
+    global commands, expected, failures
+    with open(os.path.join(run, 'commands.txt'), 'w') as f:
+        f.write('\n'.join(commands) + '\n')
+    out = subprocess.run([app] + list(options) + ['batch', 'commands.txt'], cwd=run,
+                         capture_output=True, text=True)
+    replies = out.stdout.splitlines()
+    if out.returncode != 0 or len(replies) != len(commands):
+        print('FAIL: batch exited %d with %d replies for %d commands: %s'
+              % (out.returncode, len(replies), len(commands), out.stderr.strip()))
+        sys.exit(1)
+    for command, reply, (kind, want) in zip(commands, replies, expected):
+        got = json.loads(reply)
+        if kind == 'status':
+            ok = got['status'] == want
+        else:
+            ok = got['status'] == 'success' and got['roll_nos'] == want and got['count'] == len(want)
+        if not ok:
+            failures += 1
+            if failures <= 10:
+                print('FAIL: %s%s: got %.200s' % (' '.join(options) + ' ' if options else '', command, reply))
+    commands, expected = [], []
+
+# Run 1: build every form from scratch, querying along the way
+for roll in range(1, 10001):                # Array past ARRAY_MAX into a bitmap
+    mark(roll, days[0])
+    if roll in (4096, 4097):
+        queries()
+for roll in range(-1, -5001, -1):           # Same with negative rolls, descending
+    mark(roll, days[0])
+for roll in range(2, 20001, 2):             # Bitmap that never suits runs
+    mark(roll, days[1])
+sparse = [key * 65536 + rng.randrange(65536) for key in range(-32768, 32768, 331)]
+sparse += [-2147483648, 2147483647, 0, 65535, 65536, -65536, -65537]
+for roll in sparse:                         # One small array per high key
+    mark(roll, days[2])
+for roll in rng.sample(range(0, 65536), 3000):
+    mark(roll, days[3])                     # Random array
+for roll in range(30000, 33001):            # Array that becomes a single run
+    mark(roll, days[4])
+for roll in range(60000, 70000):            # Run crossing a key boundary
+    mark(roll, days[5])
+for roll in rng.sample(range(1, 10001), 200):
+    mark(roll, days[0])                     # Duplicates
+    unmark(roll + 100000, days[0])          # Never marked
+queries()
+run_batch()
+
+# Run 2: reloaded, so dense containers are runs; mutate them
+queries()
+for roll in range(1, 7001):                 # Run -> bitmap -> array as it shrinks
+    unmark(roll, days[0])
+    if roll in (5903, 5904, 5905):
+        queries()
+queries()
+for roll in range(33001, 33101):            # Append to a run
+    mark(roll, days[4])
+for roll in range(31000, 31500):            # Punch a hole in it
+    unmark(roll, days[4])
+for roll in range(65530, 65546):            # Split the crossing run at the key boundary
+    unmark(roll, days[5])
+for roll in sparse[::2]:                    # Empty half the sparse containers
+    unmark(roll, days[2])
+for roll in rng.sample(range(0, 20001), 2000):
+    (mark if rng.random() < 0.5 else unmark)(roll, rng.choice(days))
+queries()
+run_batch()
+
+# Run 3: reloaded again, compacted, then emptied day by day
+queries()
+for day in days[2:4]:
+    for roll in sorted(present[day]):
+        unmark(roll, day)
+    queries()
+run_batch(['--compact'])
+
+if failures:
+    print('%d check(s) failed' % failures)
+    sys.exit(1)
+EOF
+status=$?
+[ "$status" -eq 0 ] && echo "roll set checks passed"
+exit "$status"
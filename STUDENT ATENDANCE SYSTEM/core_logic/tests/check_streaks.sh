@@ -0,0 +1,171 @@
+#!/usr/bin/env bash
+# Checks the streaks report (computeStreaks, nextBit, prevBit) against a
+# day-by-day Python model.
+#
+# Builds attendance_system.cpp, marks students with presence patterns chosen
+# to put run boundaries on and around 64-bit word edges (all present, all
+# absent, alternating, one day present or absent at either end, long runs,
+# random), then compares "streaks" over many windows, from empty ones to
+# several hundred working days, for the whole roster and for single students.
+# Runs once with the default weekday calendar and once with a calendar file of
+# terms, holidays and a working Saturday.
+#
+# Usage: tests/check_streaks.sh   (from core_logic/; needs g++ with C++17 and python3)
+
+set -u
+
+here="$(cd "$(dirname "$0")/.." && pwd)"
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+g++ -std=c++17 -O2 -pthread "$here/attendance_system.cpp" -o "$work/attendance_app" || exit 1
+
+python3 - "$work/attendance_app" "$work/run" <<'EOF'
+import datetime, json, os, random, shutil, subprocess, sys
+
+app, run = sys.argv[1], sys.argv[2]
+rng = random.Random(23)
+failures = 0
+
+start = datetime.date(2024, 1, 1)
+span = 500
+calendar_text = '\n'.join([
+    '# Two terms with a break, a holiday in each and one working Saturday',
+    'term 2024-01-08 2024-06-28',
+    'term 2024-08-26 2025-05-09',
+    'holiday 2024-03-29',
+    'holiday 2024-12-25',
+    'workday 2024-09-07',
+]) + '\n'
+
+def working_days(calendar):
+    """Working days in [start, start + span) under the given calendar text (None for weekdays)."""
+    days = [start + datetime.timedelta(d) for d in range(span)]
+    if calendar is None:
+        return {day for day in days if day.weekday() < 5}
+    working, exceptions, any_term = set(), [], False
+    for line in calendar.splitlines():
+        fields = line.split()
+        if not fields or fields[0].startswith('#'):
+            continue
+        if fields[0] == 'term':
+            first, last = (datetime.date.fromisoformat(f) for f in fields[1:3])
+            working |= {day for day in days if first <= day <= last and day.weekday() < 5}
+            any_term = True
+        else:
+            exceptions.append((datetime.date.fromisoformat(fields[1]), fields[0] == 'workday'))
+    if not any_term:
+        working = {day for day in days if day.weekday() < 5}
+    for day, on in exceptions:
+        (working.add if on else working.discard)(day)
+    return working
+
+def patterns(n):
+    """Presence patterns over n slots, dense around multiples of 64."""
+    yield [True] * n
+    yield [False] * n
+    yield [i % 2 == 0 for i in range(n)]
+    for edge in (1, 63, 64, 65, 127, 128, 129, 191, 192, 256):
+        yield [i < edge for i in range(n)]
+        yield [i >= edge for i in range(n)]
+        yield [i != edge for i in range(n)]
+        yield [i == edge for i in range(n)]
+    for _ in range(30):
+        density = rng.random()
+        yield [rng.random() < density for _ in range(n)]
+    for _ in range(10):                   # Long runs of random length
+        pattern, value = [], rng.random() < 0.5
+        while len(pattern) < n:
+            pattern += [value] * rng.randint(1, 150)
+            value = not value
+        yield pattern[:n]
+
+def streak_stats(presence):
+    present = sum(presence)
+    runs = []
+    length = 0
+    for bit in presence + [True]:
+        if not bit:
+            length += 1
+        elif length:
+            runs.append(length)
+            length = 0
+    current_streak = current_absence = 0
+    for bit in reversed(presence):
+        if not bit:
+            break
+        current_streak += 1
+    for bit in reversed(presence):
+        if bit:
+            break
+        current_absence += 1
+    return {'present': present, 'longest_absence': max(runs, default=0), 'absence_episodes': len(runs),
+            'current_streak': current_streak, 'current_absence': current_absence}
+
+def check(calendar):
+    global failures
+    shutil.rmtree(run, ignore_errors=True)
+    os.mkdir(run)
+    if calendar is not None:
+        with open(os.path.join(run, 'attendance_calendar.txt'), 'w') as f:
+            f.write(calendar)
+    working = working_days(calendar)
+    ordered = sorted(working)
+
+    # Patterns are laid over the working days, plus a few marks on non-working days
+    # that the report must ignore
+    marked = {}
+    for roll, pattern in enumerate(patterns(len(ordered)), 1):
+        marked[roll] = {day for day, bit in zip(ordered, pattern) if bit}
+        marked[roll] |= {start + datetime.timedelta(rng.randrange(span)) for _ in range(3)}
+    commands = ['mark %d %s' % (roll, day.isoformat()) for roll, days in marked.items() for day in sorted(days)]
+
+    windows = [(0, span - 1), (0, 0), (5, 6)]       # Everything, a Monday, a weekend
+    for length in (1, 2, 63, 64, 65, 128, 129, 300):
+        offset = rng.randrange(span - length - 1)
+        windows.append((offset, offset + length + length // 2))
+    windows += [tuple(sorted(rng.sample(range(span), 2))) for _ in range(10)]
+    queries = []
+    for first, last in windows:
+        window = (start + datetime.timedelta(first), start + datetime.timedelta(min(last, span - 1)))
+        queries.append((window, None))
+        queries.append((window, rng.choice(list(marked))))
+    commands += ['streaks %s %s%s' % (a.isoformat(), b.isoformat(), '' if roll is None else ' %d' % roll)
+                 for (a, b), roll in queries]
+
+    with open(os.path.join(run, 'commands.txt'), 'w') as f:
+        f.write('\n'.join(commands) + '\n')
+    label = 'calendar file' if calendar is not None else 'weekdays'
+    try:
+        # A bit scan that stops advancing spins forever rather than failing
+        out = subprocess.run([app, 'batch', 'commands.txt'], cwd=run, capture_output=True, text=True, timeout=120)
+    except subprocess.TimeoutExpired:
+        print('FAIL (%s): batch did not finish within 120 s' % label)
+        sys.exit(1)
+    replies = out.stdout.splitlines()
+    if out.returncode != 0 or len(replies) != len(commands):
+        print('FAIL (%s): batch exited %d with %d replies for %d commands' % (label, out.returncode, len(replies), len(commands)))
+        sys.exit(1)
+
+    for ((a, b), roll), reply in zip(queries, replies[-len(queries):]):
+        got = json.loads(reply)
+        days = [day for day in ordered if a <= day <= b]
+        want = [dict(roll_no=r, **streak_stats([day in marked[r] for day in days]))
+                for r in sorted(marked) if roll is None or r == roll]
+        if got.get('working_days') != len(days) or got.get('students') != want:
+            failures += 1
+            if failures <= 10:
+                wrong = [(g, w) for g, w in zip(got.get('students', []), want) if g != w][:1]
+                print('FAIL (%s): streaks %s %s %s: working_days %s (want %d), first difference %s'
+                      % (label, a, b, roll or '', got.get('working_days'), len(days), wrong))
+
+check(None)
+check(calendar_text)
+
+if failures:
+    print('%d check(s) failed' % failures)
+    sys.exit(1)
+EOF
+status=$?
+[ "$status" -eq 0 ] && echo "streak checks passed"
+exit "$status"
@@ -0,0 +1,161 @@
+#!/usr/bin/env bash
+# Checks that marks which cannot be written to the write-ahead log are undone.
+#
+# Builds attendance_system.cpp and fills attendance_data.wal to just under
+# 1 KiB, then runs commands under "ulimit -f 1" (with SIGXFSZ ignored) so the
+# next log write is cut short and fails:
+#   - a CLI mark and unmark must reply "could not be saved" and be undone, so a
+#     later "view" does not show the mark (or still shows the unmarked day);
+#   - a serve round with several changes must fail all of them the same way,
+#     and students registered by its marks must be unregistered again (also
+#     once far-apart roll numbers have switched the roll index to hashing);
+#   - the log must be trimmed back to its last whole record, ending in a
+#     newline, and the same commands must succeed once the limit is lifted.
+#
+# Usage: tests/check_wal_undo.sh   (from core_logic/; needs g++ with C++17 and python3)
+
+set -u
+
+here="$(cd "$(dirname "$0")/.." && pwd)"
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+g++ -std=c++17 -O2 -pthread "$here/attendance_system.cpp" -o "$work/attendance_app" || exit 1
+
+app="$work/attendance_app"
+dir="$work/run"
+wal="$dir/attendance_data.wal"
+failures=0
+
+fail() {
+    echo "FAIL: $*"
+    failures=$((failures + 1))
+}
+
+# Runs the app in the data directory
+run() {
+    (cd "$dir" && "$app" "$@" 2> /dev/null)
+}
+
+# Runs the app with writes limited to 1 KiB per file
+run_limited() {
+    (cd "$dir" && trap '' XFSZ && ulimit -f 1 && "$app" "$@" 2> /dev/null)
+}
+
+expect() {
+    local what="$1" got="$2" want="$3"
+    case "$got" in
+        *"$want"*) ;;
+        *) fail "$what: got '$got', want '$want'" ;;
+    esac
+}
+
+wal_size() {
+    wc -c < "$wal" | tr -d ' '
+}
+
+# Log ends in a newline and is as long as before the failed write
+check_wal() {
+    local what="$1" want_size="$2"
+    [ "$(wal_size)" = "$want_size" ] || fail "$what: log is $(wal_size) bytes, want $want_size"
+    [ "$(tail -c 1 "$wal" | od -An -c | tr -d ' ')" = '\n' ] || fail "$what: log does not end in a newline"
+}
+
+# Fills the log with marks until the next record no longer fits in 1 KiB
+fill_wal() {
+    local roll=100000
+    while [ ! -f "$wal" ] || [ "$(wal_size)" -lt 1010 ]; do
+        run mark "$roll" 2025-07-01 > /dev/null
+        roll=$((roll + 1))
+    done
+}
+
+mkdir "$dir"
+run mark 7 2025-07-02 > /dev/null
+fill_wal
+
+# CLI mark and unmark
+size="$(wal_size)"
+expect "limited mark" "$(run_limited mark 5 2025-07-01)" 'Attendance could not be saved'
+check_wal "limited mark" "$size"
+expect "view after limited mark" "$(run view 5)" 'Roll No: 5 not found.'
+expect "limited unmark" "$(run_limited unmark 7 2025-07-02)" 'Attendance could not be saved'
+check_wal "limited unmark" "$size"
+expect "view after limited unmark" "$(run view 7)" '"dates": ["2025-07-02"]'
+
+expect "retried mark" "$(run mark 5 2025-07-01)" 'Attendance marked for Roll No: 5'
+expect "retried unmark" "$(run unmark 7 2025-07-02)" 'Attendance unmarked for Roll No: 7'
+expect "view after retries" "$(run view 5)" '"dates": ["2025-07-01"]'
+expect "view after retries" "$(run view 7)" '"dates": []'
+
+# One serve round with several changes, then reads in a later round. Students
+# far apart switch the roll index to hashing; the round's new students share
+# probe clusters with them.
+for i in $(seq 1 300); do echo "mark $((i * 7000001)) 2025-07-03"; done > "$dir/sparse.txt"
+run batch sparse.txt > /dev/null
+run mark 7 2025-07-02 > /dev/null
+fill_wal
+size="$(wal_size)"
+(cd "$dir" && trap '' XFSZ && ulimit -f 1 && exec "$app" serve > /dev/null 2>&1) &
+server=$!
+replies="$(python3 - "$dir/attendance_app.sock" <<'EOF'
+import os, socket, sys, time
+
+path = sys.argv[1]
+for _ in range(100):
+    if os.path.exists(path):
+        break
+    time.sleep(0.05)
+
+def ask(lines):
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(path)
+        sock.sendall(''.join(line + '\n' for line in lines).encode())
+        reply = b''
+        while reply.count(b'\n') < len(lines):
+            chunk = sock.recv(65536)
+            if not chunk:
+                break
+            reply += chunk
+        return reply.decode()
+
+sys.stdout.write(ask(['mark 6 2025-07-01', 'unmark 7 2025-07-02', 'mark 8 2025-07-01',
+                      'mark 2000000000 2025-07-01', 'mark -2000000000 2025-07-01']))
+sys.stdout.write(ask(['view 6', 'view 7', 'view 8', 'view 2000000000', 'view 100000', 'absent 2025-07-02']))
+
+# New sparse students, all undone, then every earlier one must still be found
+new = ['mark %d 2025-07-01' % -(i * 7000001) for i in range(1, 301)]
+failed = ask(new).count('Attendance could not be saved')
+views = ask(['view %d' % (i * 7000001) for i in range(1, 301)] + ['view %d' % -(i * 7000001) for i in range(1, 301)])
+found = views.count('"dates": ["2025-07-03"]')
+missing = views.count('not found')
+sys.stdout.write('sparse %d %d %d\n' % (failed, found, missing))
+EOF
+)"
+check_wal "serve round" "$size" # Before shutdown, which may checkpoint
+kill "$server" 2> /dev/null
+wait "$server" 2> /dev/null
+[ "$(printf '%s\n' "$replies" | head -n 5 | grep -c 'Attendance could not be saved')" = 5 ] ||
+    fail "serve round: got '$(printf '%s\n' "$replies" | head -n 5)', want five 'could not be saved'"
+expect "serve view 6" "$(printf '%s\n' "$replies" | sed -n 6p)" 'Roll No: 6 not found.'
+expect "serve view 7" "$(printf '%s\n' "$replies" | sed -n 7p)" '"dates": ["2025-07-02"]'
+expect "serve view 8" "$(printf '%s\n' "$replies" | sed -n 8p)" 'Roll No: 8 not found.'
+expect "serve view 2000000000" "$(printf '%s\n' "$replies" | sed -n 9p)" 'Roll No: 2000000000 not found.'
+expect "serve view 100000" "$(printf '%s\n' "$replies" | sed -n 10p)" '"dates": ["2025-07-01"]'
+expect "serve sparse round" "$(printf '%s\n' "$replies" | sed -n 12p)" 'sparse 300 300 300'
+absent="$(printf '%s\n' "$replies" | sed -n 11p)"
+case "$absent" in
+    *'"roll_nos": [-2000000000'* | *' 6, '* | *' 8, '*) fail "serve absent lists an undone student: $absent" ;;
+    *'"roll_nos": [5, 100000'*) ;;
+    *) fail "serve absent: got '$absent'" ;;
+esac
+
+expect "view after serve" "$(run view 6)" 'Roll No: 6 not found.'
+expect "view after serve" "$(run view 7)" '"dates": ["2025-07-02"]'
+expect "mark after serve" "$(run mark 6 2025-07-01)" 'Attendance marked for Roll No: 6'
+
+if [ "$failures" -ne 0 ]; then
+    echo "$failures check(s) failed"
+    exit 1
+fi
+echo "write-ahead log undo checks passed"